@@ -89,6 +89,9 @@ function create( inputs, layers, actFuncs )
       prevNeuronsCount = layers[ i ];
       end
 
+   -- Create graph for recomputing faulted neurons only;
+   network.graph = createAbstractNeuronsGraph( network.neurons );
+
    return network;
    end
 
@@ -98,6 +101,7 @@ function destroy( network )
       closeId( network.neurons[ i ] );
       end
 
+   closeId( network.graph );
    closeId( network.procUnit );
    closeId( network.weights );
    closeId( network.connectors );
@@ -140,9 +144,16 @@ function train( network, vectors, err, damping, speed, epochsLimit )
    end
 
 
-function compute( network, x )
+-- Test vectors given by key are computed from their fault-free
+-- activations, so faults cost only the neurons depending on them;
+function compute( network, x, key )
    setSignals( network.connectors, 1, x );
-   computeAbstractNeurons( network.neurons, 1 );
+   if key ~= nil then
+      computeAbstractNeuronsGraph( network.graph, key );
+   else
+      computeAbstractNeurons( network.neurons, 1 );
+      end
+
    local lastLayer = network.layers[ #network.layers ];
    return getSignals( network.connectors, network.connectorsCount - lastLayer, lastLayer );
    end
@@ -19,110 +19,147 @@
 module( ..., package.seeall )
 
 
-function estimateTimeToFail( times, engine, testFunc )
-   local t = 0.0;
-   local tsqr = 0.0;
-   for i = 1, times do
-      repeat
-         if not testFunc() then
-            local x = getCurrentTime( engine );
-            t = t + x;
-            tsqr = tsqr + x * x;
-            break;
-            end
-
-         until not stepOverEngine( engine )
-
-      restartEngine( engine );
-      end
+-- Optional precision is the target relative half-width of confidence
+-- interval, times is then the budget of replicas run by batches. Estimate,
+-- bounds and replicas actually used are returned;
+function estimateTimeToFail( times, engine, testFunc, precision, batch )
+   return calcTimeToFail( times, engine, testFunc, precision, batch );
+   end
+
 
-   t = t / times;
-   tsqr = tsqr / times;
-   local d = calcMeanCI( t, tsqr, times, 0.95 );
-   return t, t - d, t + d;
+function estimateSurvivalFunction( t, times, engine, testFunc, precision, batch )
+   return calcSurvivalFunction( t, times, engine, testFunc, precision, batch );
    end
 
 
-function estimateSurvivalFunction( t, times, engine, testFunc )
-   local p = 0.0;
-   for i = 1, times do
-      local tIsTooLarge = true;
-      repeat
-         if getCurrentTime( engine ) >= t then
-            if testNetwork() then p = p + 1.0 end
-            tIsTooLarge = false;
-            break;
-            end
+function estimateComponentImportance( t, times, engine, testFunc, manager, intSrc, precision, batch )
+   return calcComponentImportance( t, times, engine, testFunc, manager, intSrc, precision, batch );
+   end
 
-         until not stepOverEngine( engine )
 
-      if tIsTooLarge then
-         if testFunc() then p = p + 1.0 end
-         end;
+-- Returns failure times, their weights and times of the last passed
+-- inspections, which differ from failure times if engine is inspected;
+function estimateTimeToFailDistribution( times, engine, testFunc )
+   return calcTimeToFailDistribution( times, engine, testFunc );
+   end
+
+
+function estimateFaultsCountDistribution( times, engine, testFunc, managers )
+   return calcFaultsCountDistribution( times, engine, testFunc, managers );
+   end
+
+
+-- Samples orders of faults of managers, whose components all have i.i.d.
+-- lifetimes and do not regenerate. Returns counts of replicas by faults
+-- count K at failure, indexed from zero, where K = n + 1 means no failure,
+-- and components count n. The counts give results for any lifetime
+-- distribution, counts[ k ] / times is faults count distribution;
+function sampleFailureOrders( times, engine, testFunc, managers )
+   return calcFailureOrders( times, engine, testFunc, managers );
+   end
+
+
+-- Probability of no failure up to time t for lifetimes with distribution
+-- distr. It is below estimateSurvivalFunction() for networks, which recover
+-- after more faults;
+function orderSurvivalFunction( t, counts, componentsCount, distr )
+   return calcOrderSurvival( counts, componentsCount, distr, t );
+   end
 
-      restartEngine( engine );
-      end
 
-   p = p / times;
-   return p, calcACProbabilityCI( p, times, 0.05 );
+-- Time to fail for lifetimes with distribution distr;
+function orderTimeToFail( counts, componentsCount, distr )
+   return calcOrderTimeToFail( counts, componentsCount, distr );
    end
 
 
-function estimateComponentImportance( t, times, engine, testFunc, manager, intSrc )
-   local p = 0.0;
-   for i = 1, times do
-      if t >= getFutureTime( engine ) then
-         while stepOverEngine( engine ) do
-            if t < getFutureTime( engine ) then break end
-            end         
+-- The same as estimateFaultsCountDistribution() from counts, which does
+-- not depend on lifetimes distribution;
+function orderFaultsCountDistribution( counts, componentsCount )
+   local total = 0;
+   for k = 0, componentsCount + 1 do total = total + counts[ k ] end
+
+   local distribution = {};
+   for k = 0, componentsCount do distribution[ k ] = counts[ k ] / total end
+
+   return distribution;
+   end
+
+
+-- The same as estimateSweep() for ESTIMATOR.TIME_TO_FAIL or
+-- ESTIMATOR.SURVIVAL_FUNCTION, but all the points of grid are computed
+-- from one sample of fault orders of managers;
+function estimateOrderSweep( estimator, times, engine, testFunc, managers, distr, grid, t )
+   local counts, n = calcFailureOrders( times, engine, testFunc, managers );
+   local results = {};
+   for i = 1, #grid do
+      local d;
+      if type( grid[ i ] ) == "table" then
+         d = createDistribution( distr, grid[ i ][ 1 ], grid[ i ][ 2 ] );
+      else
+         d = createDistribution( distr, grid[ i ] );
          end
 
-      if testFunc() then
-         simulateInterrupt( manager, intSrc );
-         if not testFunc() then p = p + 1.0 end
+      if estimator == ESTIMATOR.SURVIVAL_FUNCTION then
+         results[ i ] = { calcOrderSurvival( counts, n, d, t ) };
+      else
+         results[ i ] = { calcOrderTimeToFail( counts, n, d ) };
          end
 
-      restartEngine( engine );
+      closeId( d );
       end
 
-   p = p / times;
-   return p, calcACProbabilityCI( p, times, 0.05 );
+   return results;
    end
 
 
-function estimateTimeToFailDistribution( times, engine, testFunc )
-   local d = {};
-   for i = 1, times do
-      repeat
-         if not testFunc() then break end
-         until not stepOverEngine( engine )
+-- Estimates small probability of failure by time t with multilevel
+-- splitting: replicas reaching level i of increasing levels are cloned
+-- to run on to level i + 1, failure reaches all the levels. Scores are
+-- counts of faults, or values of scoreFunc( time ), e.g. error of network
+-- output. Returns probability, its interval from runs independent
+-- estimates and runs count;
+function estimateFailureSplitting( t, times, engine, testFunc, levels, scoreFunc, runs )
+   return calcFailureSplitting( t, times, engine, testFunc, levels, scoreFunc, runs );
+   end
 
-      d[ i ] = getCurrentTime( engine );
 
-      restartEngine( engine );
-      end
+-- Counts surviving sets of up to maxFaults failed components, which are
+-- indexed by faults count from zero, and returns them with components
+-- count. Components have to be fault-free, e.g. right after restart;
+function countSurvivingSets( maxFaults, engine, testFunc, managers )
+   return calcSurvivingSets( maxFaults, engine, testFunc, managers );
+   end
+
 
-   return d;
+-- Exact survival function of identical components with distribution
+-- distr from counts of surviving sets. Returns lower and upper bounds,
+-- which are the same if sets of all sizes are counted;
+function exactSurvivalFunction( t, counts, componentsCount, distr )
+   return calcSurvivalPolynomial( counts, componentsCount, distr, t );
    end
 
 
-function estimateFaultsCountDistribution( times, engine, testFunc, managers )
-   local d = {};
-   local componentsCount = 0;
-   for i = 1, #managers do componentsCount = componentsCount + getIntSourcesCount( managers[ i ] ) end
-   for i = 0, componentsCount do d[ i ] = 0 end
-   for i = 1, times do
-      repeat
-         if not testFunc() then break end
-         until not stepOverEngine( engine )
-
-      local faultsCount = 0;
-      for j = 1, #managers do faultsCount = faultsCount + getInterruptsCount( managers[ j ] ) end
-      d[ faultsCount ] = d[ faultsCount ] + 1;
-      restartEngine( engine );
-      end
+-- Finds minimal cut sets of up to maxFaults failed components, i.e. sets
+-- failing test whose subsets pass it. Components are numbered from zero
+-- through managers. Test has to be monotone in faults;
+function findMinimalCutSets( maxFaults, engine, testFunc, managers )
+   return calcMinimalCutSets( maxFaults, engine, testFunc, managers );
+   end
+
 
-   for i = 0, componentsCount do d[ i ] = d[ i ] / times end
-   return d;
+-- Bounds unreliability at time t by cut sets found with the same
+-- managers and maxFaults. Returns lower and upper bounds;
+function cutSetsUnreliability( t, cutSets, managers, maxFaults )
+   return calcCutSetsBounds( cutSets, managers, maxFaults, t );
    end
 
+
+-- Estimates the same for every distribution of grid, e.g. DISTR.EXP and
+-- { lambda1, lambda2, ... }, with one engine and common random numbers.
+-- Distributions of all the managers of engine are replaced by every point
+-- and restored afterwards. Returns table of { value, lower, upper, times }
+-- rows;
+function estimateSweep( estimator, times, engine, testFunc, distr, grid, t, manager, intSrc, precision, batch )
+   return calcSweep( estimator, times, engine, testFunc, distr, grid, t, manager, intSrc, precision, batch );
+   end
@@ -100,20 +100,26 @@ elseif op >= 2 and op <= 6 then
    intervals = { { 0.00001, 0.0001 }, { 0.0, 1000.0 }, { 0.0, 1000.0 } };
 
    if op == 1 then
+      -- Lifetimes are i.i.d., so all the points are computed from one
+      -- sample of fault orders;
       delta = ( intervals[ op ][ 2 ] - intervals[ op ][ 1 ] ) / ( lengths[ op ] - 1 );
-      for i = 0, lengths[ op ] - 1 do
-         x = intervals[ op ][ 1 ] + i * delta;
-         distr = createDistribution( DISTR.EXP, x );
-         manager = createInterruptManager( net.weights, distr, nil );
-         engine = createSimulationEngine();
-         appendInterruptManager( engine, manager );
-         y, dyl, dyh = reliability.estimateTimeToFail( 1000, engine, testNetwork );
+      grid = {};
+      for i = 0, lengths[ op ] - 1 do grid[ i + 1 ] = intervals[ op ][ 1 ] + i * delta end
+      distr = createDistribution( DISTR.EXP, grid[ 1 ] );
+      manager = createInterruptManager( net.weights, distr, nil );
+      engine = createSimulationEngine();
+      appendInterruptManager( engine, manager );
+      results = reliability.estimateOrderSweep( ESTIMATOR.TIME_TO_FAIL, 1000, engine, testNetwork, { manager }, DISTR.EXP, grid );
+      for i = 1, #grid do
+         x = grid[ i ];
+         y, dyl, dyh = results[ i ][ 1 ], results[ i ][ 2 ], results[ i ][ 3 ];
          print( x * 10000 .. " " .. dyl / 1000 .. " " .. y / 1000 .. " " .. dyh / 1000 );
-         closeId( engine );
-         closeId( manager );
-         closeId( distr );
          end
 
+      closeId( engine );
+      closeId( manager );
+      closeId( distr );
+
    elseif op >= 2 and op <= 5 then
       distr = createDistribution( DISTR.EXP, 0.0001 );
       manager = createInterruptManager( net.weights, distr, nil );
@@ -116,23 +116,29 @@ elseif op >= 2 and op <= 6 then
    intervals = { { 0.00001, 0.0001 }, { 0.0, 10000.0 }, { 0.0, 8000.0 } };
 
    if op == 1 then
+      -- Lifetimes are i.i.d., so all the points are computed from one
+      -- sample of fault orders;
       delta = ( intervals[ op ][ 2 ] - intervals[ op ][ 1 ] ) / ( lengths[ op ] - 1 );
-      for i = 0, lengths[ op ] - 1 do
-         x = intervals[ op ][ 1 ] + i * delta;
-         distr = createDistribution( DISTR.EXP, x );
-         manager1 = createInterruptManager( net.resistors, distr, nil );
-         manager2 = createInterruptManager( net.capacitors, distr, nil );
-         engine = createSimulationEngine();
-         appendInterruptManager( engine, manager1 );
-         appendInterruptManager( engine, manager2 );
-         y, dyl, dyh = reliability.estimateTimeToFail( 121, engine, testNetwork );
+      grid = {};
+      for i = 0, lengths[ op ] - 1 do grid[ i + 1 ] = intervals[ op ][ 1 ] + i * delta end
+      distr = createDistribution( DISTR.EXP, grid[ 1 ] );
+      manager1 = createInterruptManager( net.resistors, distr, nil );
+      manager2 = createInterruptManager( net.capacitors, distr, nil );
+      engine = createSimulationEngine();
+      appendInterruptManager( engine, manager1 );
+      appendInterruptManager( engine, manager2 );
+      results = reliability.estimateOrderSweep( ESTIMATOR.TIME_TO_FAIL, 121, engine, testNetwork, { manager1, manager2 }, DISTR.EXP, grid );
+      for i = 1, #grid do
+         x = grid[ i ];
+         y, dyl, dyh = results[ i ][ 1 ], results[ i ][ 2 ], results[ i ][ 3 ];
          print( x * 10000 .. " " .. dyl / 1000 .. " " .. y / 1000 .. " " .. dyh / 1000 );
-         closeId( engine );
-         closeId( manager2 );
-         closeId( manager1 );
-         closeId( distr );
          end
 
+      closeId( engine );
+      closeId( manager2 );
+      closeId( manager1 );
+      closeId( distr );
+
    elseif op >= 2 and op <= 5 then
       distr = createDistribution( DISTR.EXP, 0.0001 );
       manager1 = createInterruptManager( net.resistors, distr, nil );
@@ -0,0 +1,53 @@
+--   Copyright (C) 2009, 2010 Andrew Timashov
+--
+--   This file is part of NeuroWombat.
+--
+--   NeuroWombat is free software: you can redistribute it and/or modify
+--   it under the terms of the GNU General Public License as published by
+--   the Free Software Foundation, either version 3 of the License, or
+--   (at your option) any later version.
+--
+--   NeuroWombat is distributed in the hope that it will be useful,
+--   but WITHOUT ANY WARRANTY; without even the implied warranty of
+--   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+--   GNU General Public License for more details.
+--
+--   You should have received a copy of the GNU General Public License
+--   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+-- Benchmark of interrupt managers: memory module manager has 64 interrupt
+-- sources per word, every replica is simulated until all the bits are
+-- broken, so each replica handles ( 64 * words ) interrupts;
+
+replicas = 10;
+sizes = { 1, 4, 16, 64, 256, 1024 };
+
+-- Set to true to sample only the next interrupt of manager;
+lazySampling = false;
+
+print( "Sources / replica time (ms) / time per interrupt (us)" );
+for i = 1, #sizes do
+   memory = createMemoryModule( sizes[ i ] );
+   distr = createDistribution( DISTR.EXP, 0.0001 );
+   manager = createInterruptManager( memory, distr, nil );
+   setLazySampling( manager, lazySampling );
+   engine = createSimulationEngine();
+   appendInterruptManager( engine, manager );
+
+   local interrupts = 0;
+   local t = os.clock();
+   for j = 1, replicas do
+      while stepOverEngine( engine ) do interrupts = interrupts + 1 end
+      restartEngine( engine );
+      end
+
+   t = os.clock() - t;
+   print( getIntSourcesCount( manager ) .. " " .. 1000.0 * t / replicas .. " " .. 1000000.0 * t / interrupts );
+
+   closeId( engine );
+   closeId( manager );
+   closeId( distr );
+   closeId( memory );
+   end
@@ -41,7 +41,7 @@ function visualizeResults( x1, x2, pointsCount )
 function testNetwork()
    local errLimit = 1.0;
    for i = 1, #trainVectors do
-      local y = abstract.MultilayerPerceptron.compute( net, trainVectors[ i ][ 1 ] );
+      local y = abstract.MultilayerPerceptron.compute( net, trainVectors[ i ][ 1 ], i );
       if math.abs( trainVectors[ i ][ 2 ][ 1 ] - y[ 1 ] ) > errLimit then return false end
       end
 
@@ -101,20 +101,26 @@ elseif op >= 2 and op <= 6 then
    intervals = { { 0.00001, 0.0001 }, { 0.0, 1000.0 }, { 0.0, 1000.0 } };
 
    if op == 1 then
+      -- All the points share engine and random streams, so the curve is
+      -- not blurred by independent noise of every point;
       delta = ( intervals[ op ][ 2 ] - intervals[ op ][ 1 ] ) / ( lengths[ op ] - 1 );
-      for i = 0, lengths[ op ] - 1 do
-         x = intervals[ op ][ 1 ] + i * delta;
-         distr = createDistribution( DISTR.EXP, x );
-         manager = createInterruptManager( net.weights, distr, retrainNetwork );
-         engine = createSimulationEngine();
-         appendInterruptManager( engine, manager );
-         y, dyl, dyh = reliability.estimateTimeToFail( 121, engine, testNetwork );
+      grid = {};
+      for i = 0, lengths[ op ] - 1 do grid[ i + 1 ] = intervals[ op ][ 1 ] + i * delta end
+      distr = createDistribution( DISTR.EXP, grid[ 1 ] );
+      manager = createInterruptManager( net.weights, distr, retrainNetwork );
+      engine = createSimulationEngine();
+      appendInterruptManager( engine, manager );
+      results = reliability.estimateSweep( ESTIMATOR.TIME_TO_FAIL, 121, engine, testNetwork, DISTR.EXP, grid );
+      for i = 1, #grid do
+         x = grid[ i ];
+         y, dyl, dyh = results[ i ][ 1 ], results[ i ][ 2 ], results[ i ][ 3 ];
          print( x * 10000 .. " " .. dyl / 1000 .. " " .. y / 1000 .. " " .. dyh / 1000 );
-         closeId( engine );
-         closeId( manager );
-         closeId( distr );
          end
 
+      closeId( engine );
+      closeId( manager );
+      closeId( distr );
+
    elseif op >= 2 and op <= 5 then
       distr = createDistribution( DISTR.EXP, 0.0001 );
       manager = createInterruptManager( net.weights, distr, retrainNetwork );
@@ -31,6 +31,7 @@
 #include "components/abstract/AbstractConnectors.h"
 #include "components/abstract/AbstractWeights.h"
 #include "neurons/abstract/AbstractNeuron.h"
+#include "neurons/abstract/AbstractNeuronsGraph.h"
 #include "components/analog/AnalogCapacitors.h"
 #include "components/analog/AnalogComparators.h"
 #include "components/analog/AnalogResistors.h"
@@ -39,11 +40,15 @@
 #include "components/digital/DigitalConnectors.h"
 #include "components/digital/MemoryModule.h"
 #include "neurons/digital/DigitalNeuron.h"
+#include "engine/ParameterSweep.h"
+#include "engine/ReliabilityEstimator.h"
 #include "engine/SimulationEngine.h"
 #include "math/ActivationFunction.h"
 #include "math/Distribution.h"
 #include "math/OdeSystemSolver.h"
 #include "math/ProcessingUnit.h"
+#include "math/SamplingPlan.h"
+#include "math/Statistics.h"
 
 
 // It is better for API functions to use this pointer instead of
@@ -70,6 +75,31 @@ extern Kernel * kernel;
       }\
 
 
+// Reads table indexed from zero into numbers, which have to be sized;
+#define _readIndexedNumbers( L, index, numbers )\
+   lua_pushnil( L );\
+   while ( lua_next( L, index ) != 0 )\
+      {\
+      unsigned int k = lua_tointeger( L, -2 );\
+      if ( k < numbers.size() ) numbers[ k ] = lua_tonumber( L, -1 );\
+      lua_pop( L, 1 );\
+      }\
+
+
+// Runs statement of estimator, errors of Lua functions called by it stop
+// statement and set failed. Error message is left on the top of Lua
+// stack, so it is raised after estimator is deleted;
+#define _runEstimate( statement, failed )\
+   try\
+      {\
+      statement;\
+      }\
+   catch ( CustomFunctionExcp & )\
+      {\
+      failed = true;\
+      }\
+
+
 void registerApiFunctions( lua_State * L )
    {
    // Register common API functions;
@@ -84,6 +114,8 @@ void registerApiFunctions( lua_State * L )
    lua_register( L, "createAbstractNeuron", createAbstractNeuron );
    lua_register( L, "computeAbstractNeurons", computeAbstractNeurons );
    lua_register( L, "computeAbstractNeuronsC", computeAbstractNeuronsC );
+   lua_register( L, "createAbstractNeuronsGraph", createAbstractNeuronsGraph );
+   lua_register( L, "computeAbstractNeuronsGraph", computeAbstractNeuronsGraph );
    lua_register( L, "trainBPAbstractNeurons", trainBPAbstractNeurons );
    // Register analog neuron API functions;
    lua_register( L, "createAnalogCapacitors", createAnalogCapacitors );
@@ -116,6 +148,7 @@ void registerApiFunctions( lua_State * L )
    lua_register( L, "createDistribution", createDistribution );
    lua_register( L, "calcMeanCI", calcMeanCI );
    lua_register( L, "calcACProbabilityCI", calcACProbabilityCI );
+   lua_register( L, "calcSurvivalPolynomial", calcSurvivalPolynomial );
    // Simulation engine API functions;
    lua_register( L, "createInterruptManager", createInterruptManager );
    lua_register( L, "createSimulationEngine", createSimulationEngine );
@@ -123,12 +156,42 @@ void registerApiFunctions( lua_State * L )
    lua_register( L, "getIntSourcesCount", getIntSourcesCount );
    lua_register( L, "getInterruptsCount", getInterruptsCount );
    lua_register( L, "simulateInterrupt", simulateInterrupt );
+   lua_register( L, "setLazySampling", setLazySampling );
+   lua_register( L, "setFailureBias", setFailureBias );
    lua_register( L, "restartEngine", restartEngine );
+   lua_register( L, "setEngineThreads", setEngineThreads );
+   lua_register( L, "setEngineSeed", setEngineSeed );
+   lua_register( L, "getEngineSeed", getEngineSeed );
+   lua_register( L, "setEngineSampling", setEngineSampling );
+   lua_register( L, "setEngineCheckpoint", setEngineCheckpoint );
+   lua_register( L, "setEngineInspection", setEngineInspection );
+   lua_register( L, "setEngineBisection", setEngineBisection );
+   lua_register( L, "setEngineControl", setEngineControl );
+   lua_register( L, "setEngineMemo", setEngineMemo );
+   lua_register( L, "getEngineMemoStats", getEngineMemoStats );
+   lua_register( L, "getEngineSkippedTests", getEngineSkippedTests );
    lua_register( L, "stepOverEngine", stepOverEngine );
+   lua_register( L, "stepEngineUntil", stepEngineUntil );
+   lua_register( L, "stepEngineEvents", stepEngineEvents );
+   lua_register( L, "getLikelihoodRatio", getLikelihoodRatio );
    lua_register( L, "getCurrentTime", getCurrentTime );
    lua_register( L, "getFutureTime", getFutureTime );
    lua_register( L, "getCurrentSource", getCurrentSource );
    lua_register( L, "getFutureSource", getFutureSource );
+   // Reliability estimation API functions;
+   lua_register( L, "calcTimeToFail", calcTimeToFail );
+   lua_register( L, "calcSurvivalFunction", calcSurvivalFunction );
+   lua_register( L, "calcComponentImportance", calcComponentImportance );
+   lua_register( L, "calcTimeToFailDistribution", calcTimeToFailDistribution );
+   lua_register( L, "calcFaultsCountDistribution", calcFaultsCountDistribution );
+   lua_register( L, "calcFailureSplitting", calcFailureSplitting );
+   lua_register( L, "calcSurvivingSets", calcSurvivingSets );
+   lua_register( L, "calcFailureOrders", calcFailureOrders );
+   lua_register( L, "calcOrderSurvival", calcOrderSurvival );
+   lua_register( L, "calcOrderTimeToFail", calcOrderTimeToFail );
+   lua_register( L, "calcMinimalCutSets", calcMinimalCutSets );
+   lua_register( L, "calcCutSetsBounds", calcCutSetsBounds );
+   lua_register( L, "calcSweep", calcSweep );
    };
 
 
@@ -363,6 +426,8 @@ int setAbstractWeights( lua_State * L )
          if ( index < limit ) weights->at( index ) = lua_tonumber( L, -1 );
          lua_pop( L, 1 );
          }
+
+      weights->touch();
       }
 
    return 0;
@@ -478,6 +543,40 @@ int computeAbstractNeuronsC( lua_State * L )
    };
 
 
+int createAbstractNeuronsGraph( lua_State * L )
+   {
+   // Create vector for holding AbstractNeuron pointers;
+   std::vector < AbstractNeuron * > neurons;
+
+   // Read neurons argument;
+   _readKernelObjectsVector( L, 1, AbstractNeuron *, neurons );
+
+   // Create graph of neurons;
+   AbstractNeuronsGraph * graph = new AbstractNeuronsGraph( neurons );
+
+   KernelObjectId id = kernel->insertObject( graph );
+
+   lua_pushnumber( L, id );
+   return 1;
+   };
+
+
+int computeAbstractNeuronsGraph( lua_State * L )
+   {
+   // Read graph argument;
+   KernelObjectId graphId = luaL_checkinteger( L, 1 );
+   KernelObject * object = kernel->getObject( graphId );
+   AbstractNeuronsGraph * graph = dynamic_cast < AbstractNeuronsGraph * >( object );
+
+   // Read key argument;
+   unsigned int key = luaL_checkinteger( L, 2 );
+
+   graph->compute( key );
+
+   return 0;
+   };
+
+
 int trainBPAbstractNeurons( lua_State * L )
    {
    // Create vector for holding AbstractNeuron pointers;
@@ -1494,15 +1593,45 @@ int calcMeanCI( lua_State * L )
    // Read beta argument;
    double beta = luaL_checknumber( L, 4 );
 
-   double t = 0.0;
-   if ( fabs( beta - 0.95 ) < 0.0001 ) t = 1.960;
-   else if ( fabs( beta - 0.99 ) < 0.0001 ) t = 2.576;
-   else if ( fabs( beta - 0.999 ) < 0.0001 ) t = 3.291;
+   lua_pushnumber( L, calcMeanDelta( mean, meansqr, times, beta ) );
+   return 1;
+   };
 
-   double delta = t * sqrt( ( meansqr - mean * mean ) / ( times - 1.0 ) );
 
-   lua_pushnumber( L, delta );
-   return 1;
+int calcSurvivalPolynomial( lua_State * L )
+   {
+   // Read counts argument, which is indexed from zero;
+   std::vector< double > counts;
+   lua_pushnil( L );
+   while ( lua_next( L, 1 ) != 0 )
+      {
+      unsigned int index = lua_tointeger( L, -2 );
+      if ( index >= counts.size() ) counts.resize( index + 1, 0.0 );
+      counts[ index ] = lua_tonumber( L, -1 );
+      lua_pop( L, 1 );
+      }
+
+   // Read componentsCount argument;
+   unsigned int componentsCount = luaL_checkinteger( L, 2 );
+
+   // Read distribution argument;
+   KernelObjectId distributionId = luaL_checkinteger( L, 3 );
+   KernelObject * object = kernel->getObject( distributionId );
+   Distribution * distribution = dynamic_cast < Distribution * >( object );
+
+   // Read time argument;
+   double time = luaL_checknumber( L, 4 );
+
+   // Components fail by time with probability 1 - S( time );
+   double p = - expm1( distribution->logSurvival( time ) );
+
+   double lower = 0.0;
+   double upper = 0.0;
+   calcSurvivalPolynomial( counts, componentsCount, p, lower, upper );
+
+   lua_pushnumber( L, lower );
+   lua_pushnumber( L, upper );
+   return 2;
    };
 
 
@@ -1517,17 +1646,12 @@ int calcACProbabilityCI( lua_State * L )
    // Read alpha argument;
    double alpha = luaL_checknumber( L, 3 );
 
-   double x = 0.0;
-   if ( fabs( alpha - 0.05 ) < 0.0001 ) x = 1.959964;
-   else if ( fabs( alpha - 0.01 ) < 0.0001 ) x = 2.5758293;
-   else if ( fabs( alpha - 0.001 ) < 0.0001 ) x = 3.2905267;
-
-   double timesAC = times + x * x;
-   double pAC = ( p * times + 0.5 * x * x ) / timesAC;
-   double delta = x * sqrt( pAC * ( 1.0 - pAC ) / timesAC );
+   double lower = 0.0;
+   double upper = 0.0;
+   calcACProbabilityBounds( p, times, alpha, lower, upper );
 
-   lua_pushnumber( L, pAC - delta );
-   lua_pushnumber( L, pAC + delta );
+   lua_pushnumber( L, lower );
+   lua_pushnumber( L, upper );
    return 2;
    };
 
@@ -1665,6 +1789,36 @@ int simulateInterrupt( lua_State * L )
    };
 
 
+int setLazySampling( lua_State * L )
+   {
+   // Read manager argument;
+   KernelObjectId managerId = luaL_checkinteger( L, 1 );
+   KernelObject * object = kernel->getObject( managerId );
+   InterruptManager * manager = dynamic_cast < InterruptManager * >( object );
+
+   // Read lazySampling argument;
+   bool lazySampling = lua_toboolean( L, 2 );
+
+   lua_pushboolean( L, manager->setLazySampling( lazySampling ) );
+   return 1;
+   };
+
+
+int setFailureBias( lua_State * L )
+   {
+   // Read manager argument;
+   KernelObjectId managerId = luaL_checkinteger( L, 1 );
+   KernelObject * object = kernel->getObject( managerId );
+   InterruptManager * manager = dynamic_cast < InterruptManager * >( object );
+
+   // Read bias argument;
+   double bias = luaL_checknumber( L, 2 );
+
+   lua_pushboolean( L, manager->setBias( bias ) );
+   return 1;
+   };
+
+
 int restartEngine( lua_State * L )
    {
    // Read engine argument;
@@ -1679,6 +1833,197 @@ int restartEngine( lua_State * L )
    };
 
 
+int setEngineThreads( lua_State * L )
+   {
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 1 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read threadsCount argument;
+   unsigned int threadsCount = luaL_checkinteger( L, 2 );
+
+   engine->setThreadsCount( threadsCount );
+
+   return 0;
+   };
+
+
+int setEngineSeed( lua_State * L )
+   {
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 1 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read seed argument;
+   uint64_t seed = ( uint64_t ) luaL_checknumber( L, 2 );
+
+   engine->setSeed( seed );
+
+   return 0;
+   };
+
+
+int getEngineSeed( lua_State * L )
+   {
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 1 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   lua_pushnumber( L, engine->getSeed() );
+   return 1;
+   };
+
+
+int setEngineSampling( lua_State * L )
+   {
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 1 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read sampling argument;
+   int sampling = luaL_checknumber( L, 2 );
+
+   // Read pointsCount argument;
+   unsigned int pointsCount = luaL_optinteger( L, 3, 1 );
+
+   SamplingPlan * plan = NULL;
+   switch ( sampling )
+      {
+      case SAMPLING::LATIN_HYPERCUBE:
+         plan = new LatinHypercubePlan( pointsCount );
+         break;
+      case SAMPLING::SOBOL:
+         plan = new SobolPlan( pointsCount );
+         break;
+      case SAMPLING::ANTITHETIC:
+         plan = new AntitheticPlan();
+         break;
+      default:
+         // Random sampling needs no plan;
+         break;
+      }
+
+   engine->setSamplingPlan( plan );
+
+   return 0;
+   };
+
+
+int setEngineCheckpoint( lua_State * L )
+   {
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 1 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read optional fileName and interval arguments;
+   const char * fileName = luaL_optstring( L, 2, "" );
+   unsigned int interval = luaL_optinteger( L, 3, 60 );
+
+   engine->setCheckpoint( fileName, interval );
+
+   return 0;
+   };
+
+
+int setEngineInspection( lua_State * L )
+   {
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 1 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read period and optional faultsPeriod arguments;
+   double period = luaL_checknumber( L, 2 );
+   unsigned int faultsPeriod = luaL_optinteger( L, 3, 0 );
+
+   engine->setInspection( period, faultsPeriod );
+
+   return 0;
+   };
+
+
+int setEngineBisection( lua_State * L )
+   {
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 1 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read bisection argument;
+   bool bisection = lua_toboolean( L, 2 );
+
+   engine->setBisection( bisection );
+
+   return 0;
+   };
+
+
+int setEngineControl( lua_State * L )
+   {
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 1 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read manager argument, nil disables control variate;
+   object = kernel->getObject( luaL_optinteger( L, 2, 0 ) );
+   InterruptManager * manager = dynamic_cast < InterruptManager * >( object );
+
+   // Read optional faultsCount argument;
+   unsigned int faultsCount = luaL_optinteger( L, 3, 1 );
+
+   engine->setControlVariate( manager, faultsCount );
+
+   return 0;
+   };
+
+
+int setEngineMemo( lua_State * L )
+   {
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 1 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read optional capacity argument;
+   unsigned int capacity = luaL_optinteger( L, 2, 0 );
+
+   engine->setMemoCapacity( capacity );
+
+   return 0;
+   };
+
+
+int getEngineMemoStats( lua_State * L )
+   {
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 1 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   lua_pushinteger( L, engine->getMemoHits() );
+   lua_pushinteger( L, engine->getMemoMisses() );
+   return 2;
+   };
+
+
+int getEngineSkippedTests( lua_State * L )
+   {
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 1 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   lua_pushinteger( L, engine->getSkippedTests() );
+   return 1;
+   };
+
+
 int stepOverEngine( lua_State * L )
    {
    // Read engine argument;
@@ -1691,6 +2036,58 @@ int stepOverEngine( lua_State * L )
    };
 
 
+int stepEngineUntil( lua_State * L )
+   {
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 1 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read time argument;
+   double time = luaL_checknumber( L, 2 );
+
+   unsigned int eventsCount = engine->stepUntil( time );
+
+   lua_pushnumber( L, engine->getCurrentTime() );
+   lua_pushnumber( L, eventsCount );
+   return 2;
+   };
+
+
+int stepEngineEvents( lua_State * L )
+   {
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 1 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read count argument;
+   lua_Integer count = luaL_checkinteger( L, 2 );
+   luaL_argcheck( L, count >= 0, 2, "non-negative count expected" );
+
+   unsigned int eventsCount = engine->stepEvents( ( unsigned int ) count );
+
+   lua_pushnumber( L, engine->getCurrentTime() );
+   lua_pushnumber( L, eventsCount );
+   return 2;
+   };
+
+
+int getLikelihoodRatio( lua_State * L )
+   {
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 1 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read time argument, current time by default;
+   double time = luaL_optnumber( L, 2, engine->getCurrentTime() );
+
+   lua_pushnumber( L, engine->getLikelihoodRatio( time ) );
+   return 1;
+   };
+
+
 int getCurrentTime( lua_State * L )
    {
    // Read engine argument;
@@ -1759,3 +2156,705 @@ int getFutureSource( lua_State * L )
    lua_pushnumber( L, intSource );
    return 2;
    };
+
+
+/***************************************************************************
+ *   Reliability estimation API functions implementation                   *
+ ***************************************************************************/
+
+
+int calcTimeToFail( lua_State * L )
+   {
+   // Read times argument;
+   unsigned int times = luaL_checkinteger( L, 1 );
+
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 2 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read testFunction argument;
+   luaL_checktype( L, 3, LUA_TFUNCTION );
+   ReliabilityEstimator * estimator = new ReliabilityEstimator( engine, new CustomFunction( 3 ) );
+
+   // Read optional precision and batchSize arguments;
+   double precision = luaL_optnumber( L, 4, 0.0 );
+   unsigned int batchSize = luaL_optinteger( L, 5, 100 );
+   estimator->setPrecision( precision, batchSize );
+
+   Estimate estimate;
+   bool failed = false;
+   _runEstimate( estimate = estimator->estimateTimeToFail( times ), failed );
+   delete estimator;
+
+   if ( failed )
+      {
+      // Restart replica to restore components;
+      engine->setReplica( engine->getReplica() );
+      return luaL_error( L, "%s", lua_tostring( L, -1 ) );
+      }
+
+   lua_pushnumber( L, estimate.value );
+   lua_pushnumber( L, estimate.lower );
+   lua_pushnumber( L, estimate.upper );
+   lua_pushnumber( L, estimate.times );
+   return 4;
+   };
+
+
+int calcSurvivalFunction( lua_State * L )
+   {
+   // Read time argument;
+   double time = luaL_checknumber( L, 1 );
+
+   // Read times argument;
+   unsigned int times = luaL_checkinteger( L, 2 );
+
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 3 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read testFunction argument;
+   luaL_checktype( L, 4, LUA_TFUNCTION );
+   ReliabilityEstimator * estimator = new ReliabilityEstimator( engine, new CustomFunction( 4 ) );
+
+   // Read optional precision and batchSize arguments;
+   double precision = luaL_optnumber( L, 5, 0.0 );
+   unsigned int batchSize = luaL_optinteger( L, 6, 100 );
+   estimator->setPrecision( precision, batchSize );
+
+   Estimate estimate;
+   bool failed = false;
+   _runEstimate( estimate = estimator->estimateSurvivalFunction( time, times ), failed );
+   delete estimator;
+
+   if ( failed )
+      {
+      // Restart replica to restore components;
+      engine->setReplica( engine->getReplica() );
+      return luaL_error( L, "%s", lua_tostring( L, -1 ) );
+      }
+
+   lua_pushnumber( L, estimate.value );
+   lua_pushnumber( L, estimate.lower );
+   lua_pushnumber( L, estimate.upper );
+   lua_pushnumber( L, estimate.times );
+   return 4;
+   };
+
+
+int calcComponentImportance( lua_State * L )
+   {
+   KernelObject * object = NULL;
+
+   // Read time argument;
+   double time = luaL_checknumber( L, 1 );
+
+   // Read times argument;
+   unsigned int times = luaL_checkinteger( L, 2 );
+
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 3 );
+   object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read manager argument;
+   KernelObjectId managerId = luaL_checkinteger( L, 5 );
+   object = kernel->getObject( managerId );
+   InterruptManager * manager = dynamic_cast < InterruptManager * >( object );
+
+   // Read intSource argument;
+   unsigned int intSource = luaL_checkinteger( L, 6 );
+
+   // Read testFunction argument;
+   luaL_checktype( L, 4, LUA_TFUNCTION );
+   ReliabilityEstimator * estimator = new ReliabilityEstimator( engine, new CustomFunction( 4 ) );
+
+   // Read optional precision and batchSize arguments;
+   double precision = luaL_optnumber( L, 7, 0.0 );
+   unsigned int batchSize = luaL_optinteger( L, 8, 100 );
+   estimator->setPrecision( precision, batchSize );
+
+   Estimate estimate;
+   bool failed = false;
+   _runEstimate( estimate = estimator->estimateComponentImportance( time, times, manager, intSource ), failed );
+   delete estimator;
+
+   if ( failed )
+      {
+      // Restart replica to restore components;
+      engine->setReplica( engine->getReplica() );
+      return luaL_error( L, "%s", lua_tostring( L, -1 ) );
+      }
+
+   lua_pushnumber( L, estimate.value );
+   lua_pushnumber( L, estimate.lower );
+   lua_pushnumber( L, estimate.upper );
+   lua_pushnumber( L, estimate.times );
+   return 4;
+   };
+
+
+int calcTimeToFailDistribution( lua_State * L )
+   {
+   // Read times argument;
+   unsigned int times = luaL_checkinteger( L, 1 );
+
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 2 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read testFunction argument;
+   luaL_checktype( L, 3, LUA_TFUNCTION );
+   ReliabilityEstimator * estimator = new ReliabilityEstimator( engine, new CustomFunction( 3 ) );
+
+   std::vector< double > distribution;
+   std::vector< double > weights;
+   std::vector< double > lowerBounds;
+   bool failed = false;
+   _runEstimate( estimator->estimateTimeToFailDistribution( times, distribution, weights, lowerBounds ), failed );
+   delete estimator;
+
+   if ( failed )
+      {
+      // Restart replica to restore components;
+      engine->setReplica( engine->getReplica() );
+      return luaL_error( L, "%s", lua_tostring( L, -1 ) );
+      }
+
+   // Create tables of times, their weights and lower bounds;
+   lua_newtable( L );
+   lua_newtable( L );
+   lua_newtable( L );
+   for ( unsigned int i = 0; i < distribution.size(); i ++ )
+      {
+      // Increase key by 1 to provide compatibility between C and Lua-style arrays;
+      lua_pushnumber( L, i + 1 );
+      lua_pushnumber( L, distribution[ i ] );
+      lua_rawset( L, -5 );
+
+      lua_pushnumber( L, i + 1 );
+      lua_pushnumber( L, weights[ i ] );
+      lua_rawset( L, -4 );
+
+      lua_pushnumber( L, i + 1 );
+      lua_pushnumber( L, lowerBounds[ i ] );
+      lua_rawset( L, -3 );
+      }
+
+   return 3;
+   };
+
+
+int calcFaultsCountDistribution( lua_State * L )
+   {
+   // Read times argument;
+   unsigned int times = luaL_checkinteger( L, 1 );
+
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 2 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read managers argument;
+   std::vector< InterruptManager * > managers;
+   _readKernelObjectsVector( L, 4, InterruptManager *, managers );
+
+   // Read testFunction argument;
+   luaL_checktype( L, 3, LUA_TFUNCTION );
+   ReliabilityEstimator * estimator = new ReliabilityEstimator( engine, new CustomFunction( 3 ) );
+
+   std::vector< double > distribution;
+   bool failed = false;
+   _runEstimate( estimator->estimateFaultsCountDistribution( times, managers, distribution ), failed );
+   delete estimator;
+
+   if ( failed )
+      {
+      // Restart replica to restore components;
+      engine->setReplica( engine->getReplica() );
+      return luaL_error( L, "%s", lua_tostring( L, -1 ) );
+      }
+
+   // Create table, faults count distribution is indexed from zero;
+   lua_newtable( L );
+   for ( unsigned int i = 0; i < distribution.size(); i ++ )
+      {
+      lua_pushnumber( L, i );
+      lua_pushnumber( L, distribution[ i ] );
+      lua_rawset( L, -3 );
+      }
+
+   return 1;
+   };
+
+
+int calcFailureSplitting( lua_State * L )
+   {
+   // Read time argument;
+   double time = luaL_checknumber( L, 1 );
+
+   // Read times argument;
+   unsigned int times = luaL_checkinteger( L, 2 );
+
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 3 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read levels argument;
+   luaL_checktype( L, 5, LUA_TTABLE );
+   std::vector< double > levels;
+   for ( unsigned int i = 1; i <= lua_objlen( L, 5 ); i ++ )
+      {
+      lua_rawgeti( L, 5, i );
+      levels.push_back( lua_tonumber( L, -1 ) );
+      lua_pop( L, 1 );
+      }
+
+   // Read optional scoreFunction argument, scores are counts of
+   // interrupts without it;
+   CustomFunction * scoreFunction = NULL;
+   if ( lua_isfunction( L, 6 ) )
+      {
+      scoreFunction = new CustomFunction( 6 );
+
+      // Capture object;
+      scoreFunction->capture();
+      }
+
+   // Read optional runs argument;
+   unsigned int runs = luaL_optinteger( L, 7, 10 );
+
+   // Read testFunction argument;
+   luaL_checktype( L, 4, LUA_TFUNCTION );
+   ReliabilityEstimator * estimator = new ReliabilityEstimator( engine, new CustomFunction( 4 ) );
+
+   Estimate estimate;
+   bool failed = false;
+   _runEstimate( estimate = estimator->estimateFailureSplitting( time, times, levels, scoreFunction, runs ), failed );
+   delete estimator;
+
+   // Release captured object;
+   if ( scoreFunction != NULL ) scoreFunction->release();
+
+   if ( failed )
+      {
+      // Restart replica to restore components;
+      engine->setReplica( engine->getReplica() );
+      return luaL_error( L, "%s", lua_tostring( L, -1 ) );
+      }
+
+   lua_pushnumber( L, estimate.value );
+   lua_pushnumber( L, estimate.lower );
+   lua_pushnumber( L, estimate.upper );
+   lua_pushnumber( L, estimate.times );
+   return 4;
+   };
+
+
+int calcSurvivingSets( lua_State * L )
+   {
+   // Read maxFaults argument;
+   unsigned int maxFaults = luaL_checkinteger( L, 1 );
+
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 2 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read managers argument;
+   std::vector< InterruptManager * > managers;
+   _readKernelObjectsVector( L, 4, InterruptManager *, managers );
+
+   // Read testFunction argument;
+   luaL_checktype( L, 3, LUA_TFUNCTION );
+   ReliabilityEstimator * estimator = new ReliabilityEstimator( engine, new CustomFunction( 3 ) );
+
+   std::vector< double > counts;
+   bool failed = false;
+   _runEstimate( estimator->countSurvivingSets( maxFaults, managers, counts ), failed );
+   delete estimator;
+
+   if ( failed )
+      {
+      // Restart replica to restore components;
+      engine->setReplica( engine->getReplica() );
+      return luaL_error( L, "%s", lua_tostring( L, -1 ) );
+      }
+
+   unsigned int componentsCount = 0;
+   for ( unsigned int i = 0; i < managers.size(); i ++ )
+      {
+      componentsCount += managers[ i ]->getIntSourcesCount();
+      }
+
+   // Create table, sets are indexed by faults count from zero;
+   lua_newtable( L );
+   for ( unsigned int i = 0; i < counts.size(); i ++ )
+      {
+      lua_pushnumber( L, i );
+      lua_pushnumber( L, counts[ i ] );
+      lua_rawset( L, -3 );
+      }
+
+   lua_pushinteger( L, componentsCount );
+   return 2;
+   };
+
+
+int calcFailureOrders( lua_State * L )
+   {
+   // Read times argument;
+   unsigned int times = luaL_checkinteger( L, 1 );
+
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 2 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read managers argument;
+   std::vector< InterruptManager * > managers;
+   _readKernelObjectsVector( L, 4, InterruptManager *, managers );
+
+   // Read testFunction argument;
+   luaL_checktype( L, 3, LUA_TFUNCTION );
+   ReliabilityEstimator * estimator = new ReliabilityEstimator( engine, new CustomFunction( 3 ) );
+
+   std::vector< double > counts;
+   bool failed = false;
+   _runEstimate( estimator->sampleFailureOrders( times, managers, counts ), failed );
+   delete estimator;
+
+   if ( failed )
+      {
+      // Restart replica to restore components;
+      engine->setReplica( engine->getReplica() );
+      return luaL_error( L, "%s", lua_tostring( L, -1 ) );
+      }
+
+   // Create table, replicas are indexed by faults count from zero;
+   lua_newtable( L );
+   for ( unsigned int i = 0; i < counts.size(); i ++ )
+      {
+      lua_pushnumber( L, i );
+      lua_pushnumber( L, counts[ i ] );
+      lua_rawset( L, -3 );
+      }
+
+   lua_pushinteger( L, counts.size() - 2 );
+   return 2;
+   };
+
+
+int calcOrderSurvival( lua_State * L )
+   {
+   // Read componentsCount argument;
+   unsigned int componentsCount = luaL_checkinteger( L, 2 );
+
+   // Read counts argument;
+   luaL_checktype( L, 1, LUA_TTABLE );
+   std::vector< double > counts( componentsCount + 2, 0.0 );
+   _readIndexedNumbers( L, 1, counts );
+
+   // Read distribution argument;
+   KernelObjectId distributionId = luaL_checkinteger( L, 3 );
+   KernelObject * object = kernel->getObject( distributionId );
+   Distribution * distribution = dynamic_cast < Distribution * >( object );
+
+   // Read time argument;
+   double time = luaL_checknumber( L, 4 );
+
+   // Replica with K survives time if less than K components fail;
+   std::vector< double > pmf;
+   calcBinomialDistribution( componentsCount, - expm1( distribution->logSurvival( time ) ), pmf );
+
+   std::vector< double > survivals( componentsCount + 2, 0.0 );
+   for ( unsigned int k = 1; k < survivals.size(); k ++ )
+      {
+      survivals[ k ] = survivals[ k - 1 ] + pmf[ k - 1 ];
+      }
+
+   double delta = 0.0;
+   double mean = calcCountsMean( counts, survivals, 0.95, delta );
+
+   double times = 0.0;
+   for ( unsigned int k = 0; k < counts.size(); k ++ ) times += counts[ k ];
+
+   lua_pushnumber( L, mean );
+   lua_pushnumber( L, mean - delta );
+   lua_pushnumber( L, mean + delta );
+   lua_pushnumber( L, times );
+   return 4;
+   };
+
+
+int calcOrderTimeToFail( lua_State * L )
+   {
+   // Read componentsCount argument;
+   unsigned int componentsCount = luaL_checkinteger( L, 2 );
+
+   // Read counts argument;
+   luaL_checktype( L, 1, LUA_TTABLE );
+   std::vector< double > counts( componentsCount + 2, 0.0 );
+   _readIndexedNumbers( L, 1, counts );
+
+   // Read distribution argument;
+   KernelObjectId distributionId = luaL_checkinteger( L, 3 );
+   KernelObject * object = kernel->getObject( distributionId );
+   Distribution * distribution = dynamic_cast < Distribution * >( object );
+
+   // Replica with K fails at K-th ordered lifetime, replicas failed
+   // without faults or never failed give 0 as in calcTimeToFail();
+   std::vector< double > means;
+   distribution->orderedMeans( componentsCount, means );
+
+   std::vector< double > failureTimes( componentsCount + 2, 0.0 );
+   for ( unsigned int k = 1; k <= componentsCount; k ++ ) failureTimes[ k ] = means[ k - 1 ];
+
+   double delta = 0.0;
+   double mean = calcCountsMean( counts, failureTimes, 0.95, delta );
+
+   double times = 0.0;
+   for ( unsigned int k = 0; k < counts.size(); k ++ ) times += counts[ k ];
+
+   lua_pushnumber( L, mean );
+   lua_pushnumber( L, mean - delta );
+   lua_pushnumber( L, mean + delta );
+   lua_pushnumber( L, times );
+   return 4;
+   };
+
+
+int calcMinimalCutSets( lua_State * L )
+   {
+   // Read maxFaults argument;
+   unsigned int maxFaults = luaL_checkinteger( L, 1 );
+
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 2 );
+   KernelObject * object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read managers argument;
+   std::vector< InterruptManager * > managers;
+   _readKernelObjectsVector( L, 4, InterruptManager *, managers );
+
+   // Read testFunction argument;
+   luaL_checktype( L, 3, LUA_TFUNCTION );
+   ReliabilityEstimator * estimator = new ReliabilityEstimator( engine, new CustomFunction( 3 ) );
+
+   std::vector< std::vector< unsigned int > > cutSets;
+   bool failed = false;
+   _runEstimate( estimator->findMinimalCutSets( maxFaults, managers, cutSets ), failed );
+   delete estimator;
+
+   if ( failed )
+      {
+      // Restart replica to restore components;
+      engine->setReplica( engine->getReplica() );
+      return luaL_error( L, "%s", lua_tostring( L, -1 ) );
+      }
+
+   // Create table of cut sets, sources are numbered from zero through
+   // managers;
+   lua_newtable( L );
+   for ( unsigned int i = 0; i < cutSets.size(); i ++ )
+      {
+      // Increase key by 1 to provide compatibility between C and Lua-style arrays;
+      lua_pushnumber( L, i + 1 );
+      lua_newtable( L );
+
+      for ( unsigned int j = 0; j < cutSets[ i ].size(); j ++ )
+         {
+         lua_pushnumber( L, j + 1 );
+         lua_pushnumber( L, cutSets[ i ][ j ] );
+         lua_rawset( L, -3 );
+         }
+
+      lua_rawset( L, -3 );
+      }
+
+   return 1;
+   };
+
+
+int calcCutSetsBounds( lua_State * L )
+   {
+   // Read cutSets argument;
+   luaL_checktype( L, 1, LUA_TTABLE );
+   std::vector< std::vector< unsigned int > > cutSets( lua_objlen( L, 1 ) );
+   for ( unsigned int i = 0; i < cutSets.size(); i ++ )
+      {
+      lua_rawgeti( L, 1, i + 1 );
+      for ( unsigned int j = 1; j <= lua_objlen( L, -1 ); j ++ )
+         {
+         lua_rawgeti( L, -1, j );
+         cutSets[ i ].push_back( lua_tointeger( L, -1 ) );
+         lua_pop( L, 1 );
+         }
+
+      lua_pop( L, 1 );
+      }
+
+   // Read managers argument;
+   std::vector< InterruptManager * > managers;
+   _readKernelObjectsVector( L, 2, InterruptManager *, managers );
+
+   // Read maxFaults argument;
+   unsigned int maxFaults = luaL_checkinteger( L, 3 );
+
+   // Read time argument;
+   double time = luaL_checknumber( L, 4 );
+
+   // Sources fail by time with probability 1 - S( time ) of their
+   // manager's distribution;
+   std::vector< double > p;
+   for ( unsigned int i = 0; i < managers.size(); i ++ )
+      {
+      double q = - expm1( managers[ i ]->getDistribution()->logSurvival( time ) );
+      p.insert( p.end(), managers[ i ]->getIntSourcesCount(), q );
+      }
+
+   for ( unsigned int i = 0; i < cutSets.size(); i ++ )
+      {
+      for ( unsigned int j = 0; j < cutSets[ i ].size(); j ++ )
+         {
+         if ( cutSets[ i ][ j ] >= p.size() ) return luaL_error( L, "cut set source is out of range" );
+         }
+      }
+
+   double lower = 0.0;
+   double upper = 0.0;
+   calcCutSetsBounds( cutSets, p, maxFaults, lower, upper );
+
+   lua_pushnumber( L, lower );
+   lua_pushnumber( L, upper );
+   return 2;
+   };
+
+
+int calcSweep( lua_State * L )
+   {
+   KernelObject * object = NULL;
+
+   // Read estimator argument;
+   int estimator = luaL_checknumber( L, 1 );
+
+   // Read times argument;
+   unsigned int times = luaL_checkinteger( L, 2 );
+
+   // Read engine argument;
+   KernelObjectId engineId = luaL_checkinteger( L, 3 );
+   object = kernel->getObject( engineId );
+   SimulationEngine * engine = dynamic_cast < SimulationEngine * >( object );
+
+   // Read distr argument;
+   int distr = luaL_checknumber( L, 5 );
+   luaL_argcheck( L, distr == DISTR::EXP || distr == DISTR::WEIBULL, 5, "EXP or WEIBULL expected" );
+
+   // Read grid argument, Weibull points are { teta, beta } pairs. Rows of
+   // results follow points, so malformed point is an error;
+   luaL_checktype( L, 6, LUA_TTABLE );
+   std::vector< Distribution * > distributions;
+   for ( unsigned int i = 1; i <= lua_objlen( L, 6 ); i ++ )
+      {
+      Distribution * distribution = NULL;
+      lua_rawgeti( L, 6, i );
+
+      if ( distr == DISTR::EXP && lua_isnumber( L, -1 ) )
+         {
+         distribution = new ExponentialDistribution( lua_tonumber( L, -1 ) );
+         }
+      else if ( distr == DISTR::WEIBULL && lua_istable( L, -1 ) )
+         {
+         lua_rawgeti( L, -1, 1 );
+         lua_rawgeti( L, -2, 2 );
+         if ( lua_isnumber( L, -2 ) && lua_isnumber( L, -1 ) )
+            {
+            distribution = new WeibullDistribution( lua_tonumber( L, -2 ), lua_tonumber( L, -1 ) );
+            }
+
+         lua_pop( L, 2 );
+         }
+
+      lua_pop( L, 1 );
+
+      if ( distribution == NULL )
+         {
+         for ( unsigned int j = 0; j < distributions.size(); j ++ )
+            {
+            // Release captured object;
+            distributions[ j ]->release();
+            }
+
+         return luaL_error( L, "malformed grid point %d", i );
+         }
+
+      // Capture object;
+      distribution->capture();
+      distributions.push_back( distribution );
+      }
+
+   // Read optional time, manager and intSource arguments;
+   double time = luaL_optnumber( L, 7, 0.0 );
+   object = kernel->getObject( luaL_optinteger( L, 8, 0 ) );
+   InterruptManager * manager = dynamic_cast < InterruptManager * >( object );
+   unsigned int intSource = luaL_optinteger( L, 9, 0 );
+
+   // Read optional precision and batchSize arguments;
+   double precision = luaL_optnumber( L, 10, 0.0 );
+   unsigned int batchSize = luaL_optinteger( L, 11, 100 );
+
+   // Read testFunction argument;
+   luaL_checktype( L, 4, LUA_TFUNCTION );
+   ParameterSweep * sweep = new ParameterSweep( engine, new CustomFunction( 4 ) );
+   sweep->setEstimator( ( ESTIMATOR::T_ESTIMATOR ) estimator, time, manager, intSource );
+   sweep->setPrecision( precision, batchSize );
+
+   std::vector< Estimate > estimates;
+   bool failed = false;
+   _runEstimate( sweep->run( distributions, times, estimates ), failed );
+   delete sweep;
+
+   for ( unsigned int i = 0; i < distributions.size(); i ++ )
+      {
+      // Release captured object;
+      distributions[ i ]->release();
+      }
+
+   if ( failed )
+      {
+      // Restart replica to restore components;
+      engine->setReplica( engine->getReplica() );
+      return luaL_error( L, "%s", lua_tostring( L, -1 ) );
+      }
+
+   // Create table of { value, lower, upper, times } rows;
+   lua_newtable( L );
+   for ( unsigned int i = 0; i < estimates.size(); i ++ )
+      {
+      // Increase key by 1 to provide compatibility between C and Lua-style arrays;
+      lua_pushnumber( L, i + 1 );
+      lua_newtable( L );
+
+      lua_pushnumber( L, 1 );
+      lua_pushnumber( L, estimates[ i ].value );
+      lua_rawset( L, -3 );
+      lua_pushnumber( L, 2 );
+      lua_pushnumber( L, estimates[ i ].lower );
+      lua_rawset( L, -3 );
+      lua_pushnumber( L, 3 );
+      lua_pushnumber( L, estimates[ i ].upper );
+      lua_rawset( L, -3 );
+      lua_pushnumber( L, 4 );
+      lua_pushnumber( L, estimates[ i ].times );
+      lua_rawset( L, -3 );
+
+      lua_rawset( L, -3 );
+      }
+
+   return 1;
+   };
@@ -72,6 +72,12 @@ extern "C" int computeAbstractNeurons( lua_State * L );
 extern "C" int computeAbstractNeuronsC( lua_State * L );
 
 
+extern "C" int createAbstractNeuronsGraph( lua_State * L );
+
+
+extern "C" int computeAbstractNeuronsGraph( lua_State * L );
+
+
 extern "C" int trainBPAbstractNeurons( lua_State * L );
 
 
@@ -171,6 +177,9 @@ extern "C" int createDistribution( lua_State * L );
 extern "C" int calcMeanCI( lua_State * L );
 
 
+extern "C" int calcSurvivalPolynomial( lua_State * L );
+
+
 extern "C" int calcACProbabilityCI( lua_State * L );
 
 
@@ -197,12 +206,60 @@ extern "C" int getInterruptsCount( lua_State * L );
 extern "C" int simulateInterrupt( lua_State * L );
 
 
+extern "C" int setLazySampling( lua_State * L );
+
+
+extern "C" int setFailureBias( lua_State * L );
+
+
 extern "C" int restartEngine( lua_State * L );
 
 
+extern "C" int setEngineThreads( lua_State * L );
+
+
+extern "C" int setEngineSeed( lua_State * L );
+
+
+extern "C" int getEngineSeed( lua_State * L );
+
+
+extern "C" int setEngineSampling( lua_State * L );
+
+
+extern "C" int setEngineCheckpoint( lua_State * L );
+
+
+extern "C" int setEngineInspection( lua_State * L );
+
+
+extern "C" int setEngineBisection( lua_State * L );
+
+
+extern "C" int setEngineControl( lua_State * L );
+
+
+extern "C" int setEngineMemo( lua_State * L );
+
+
+extern "C" int getEngineMemoStats( lua_State * L );
+
+
+extern "C" int getEngineSkippedTests( lua_State * L );
+
+
 extern "C" int stepOverEngine( lua_State * L );
 
 
+extern "C" int stepEngineUntil( lua_State * L );
+
+
+extern "C" int stepEngineEvents( lua_State * L );
+
+
+extern "C" int getLikelihoodRatio( lua_State * L );
+
+
 extern "C" int getCurrentTime( lua_State * L );
 
 
@@ -215,4 +272,48 @@ extern "C" int getCurrentSource( lua_State * L );
 extern "C" int getFutureSource( lua_State * L );
 
 
+/***************************************************************************
+ *   Reliability estimation API functions declaration                      *
+ ***************************************************************************/
+
+
+extern "C" int calcTimeToFail( lua_State * L );
+
+
+extern "C" int calcSurvivalFunction( lua_State * L );
+
+
+extern "C" int calcComponentImportance( lua_State * L );
+
+
+extern "C" int calcTimeToFailDistribution( lua_State * L );
+
+
+extern "C" int calcFaultsCountDistribution( lua_State * L );
+
+
+extern "C" int calcFailureSplitting( lua_State * L );
+
+
+extern "C" int calcSurvivingSets( lua_State * L );
+
+
+extern "C" int calcFailureOrders( lua_State * L );
+
+
+extern "C" int calcOrderSurvival( lua_State * L );
+
+
+extern "C" int calcOrderTimeToFail( lua_State * L );
+
+
+extern "C" int calcMinimalCutSets( lua_State * L );
+
+
+extern "C" int calcCutSetsBounds( lua_State * L );
+
+
+extern "C" int calcSweep( lua_State * L );
+
+
 #endif
@@ -21,7 +21,9 @@
 #include "api/constants.h"
 #include "math/ActivationFunction.h"
 #include "math/ProcessingUnit.h"
+#include "engine/ParameterSweep.h"
 #include "math/Distribution.h"
+#include "math/SamplingPlan.h"
 
 
 #include <stdio.h>
@@ -33,6 +35,8 @@ void registerApiConstants( lua_State * L )
    registerProcessingUnits( L );
    registerCoefficientUsage( L );
    registerDistributions( L );
+   registerSamplings( L );
+   registerEstimators( L );
    };
 
 
@@ -225,3 +229,78 @@ void registerDistributions( lua_State * L )
    // Register this table;
    lua_setglobal( L, "DISTR" );
    };
+
+
+void registerSamplings( lua_State * L )
+   {
+   // Create an empty table;
+   lua_newtable( L );
+
+   // Create metatable;
+   lua_newtable( L );
+   lua_pushstring( L, "__index" );
+
+   // Create table to be set as __index;
+   lua_newtable( L );
+   lua_pushstring( L, "ANTITHETIC" );
+   lua_pushnumber( L, SAMPLING::ANTITHETIC );
+   lua_rawset( L, -3 );
+   lua_pushstring( L, "LATIN_HYPERCUBE" );
+   lua_pushnumber( L, SAMPLING::LATIN_HYPERCUBE );
+   lua_rawset( L, -3 );
+   lua_pushstring( L, "RANDOM" );
+   lua_pushnumber( L, SAMPLING::RANDOM );
+   lua_rawset( L, -3 );
+   lua_pushstring( L, "SOBOL" );
+   lua_pushnumber( L, SAMPLING::SOBOL );
+   lua_rawset( L, -3 );
+
+   // Set this table as __index field for metatable;
+   lua_rawset( L, -3 );
+
+   lua_pushstring( L, "__newindex" );
+   lua_pushcfunction( L, newIndexHandler );
+   lua_rawset( L, -3 );
+
+   // Set metatable to an empty table;
+   lua_setmetatable( L, -2 );
+
+   // Register this table;
+   lua_setglobal( L, "SAMPLING" );
+   };
+
+
+void registerEstimators( lua_State * L )
+   {
+   // Create an empty table;
+   lua_newtable( L );
+
+   // Create metatable;
+   lua_newtable( L );
+   lua_pushstring( L, "__index" );
+
+   // Create table to be set as __index;
+   lua_newtable( L );
+   lua_pushstring( L, "COMPONENT_IMPORTANCE" );
+   lua_pushnumber( L, ESTIMATOR::COMPONENT_IMPORTANCE );
+   lua_rawset( L, -3 );
+   lua_pushstring( L, "SURVIVAL_FUNCTION" );
+   lua_pushnumber( L, ESTIMATOR::SURVIVAL_FUNCTION );
+   lua_rawset( L, -3 );
+   lua_pushstring( L, "TIME_TO_FAIL" );
+   lua_pushnumber( L, ESTIMATOR::TIME_TO_FAIL );
+   lua_rawset( L, -3 );
+
+   // Set this table as __index field for metatable;
+   lua_rawset( L, -3 );
+
+   lua_pushstring( L, "__newindex" );
+   lua_pushcfunction( L, newIndexHandler );
+   lua_rawset( L, -3 );
+
+   // Set metatable to an empty table;
+   lua_setmetatable( L, -2 );
+
+   // Register this table;
+   lua_setglobal( L, "ESTIMATOR" );
+   };
@@ -52,4 +52,10 @@ inline void registerCoefficientUsage( lua_State * L );
 inline void registerDistributions( lua_State * L );
 
 
+inline void registerSamplings( lua_State * L );
+
+
+inline void registerEstimators( lua_State * L );
+
+
 #endif
@@ -0,0 +1,115 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#ifndef UNDOLOG_H
+#define UNDOLOG_H
+
+
+#include <utility>
+#include <vector>
+
+
+#include "components/ComponentsSet.h"
+
+
+/***************************************************************************
+ *   UndoLog class declaration                                             *
+ ***************************************************************************/
+
+
+// Keeps previous values of changed components, so they are restored in
+// O( changes ) instead of copying the whole set;
+template < class T >
+   class UndoLog
+      {
+      public:
+         UndoLog( ComponentsSet < T > * components = NULL );
+         virtual ~UndoLog();
+
+         // Should be called before component is changed;
+         void record( unsigned int index );
+
+         unsigned int getCount() const;
+
+         // Restores components changed after the first count records;
+         void rollback( unsigned int count = 0 );
+
+         // Forgets records without restoring components;
+         void clear();
+
+      private:
+         ComponentsSet < T > * components;
+         std::vector< std::pair< unsigned int, T > > records;
+      };
+
+
+/***************************************************************************
+ *   UndoLog class implementation                                          *
+ ***************************************************************************/
+
+
+template < class T >
+   UndoLog < T >::UndoLog( ComponentsSet < T > * components )
+      {
+      this->components = components;
+      };
+
+
+template < class T >
+   UndoLog < T >::~UndoLog()
+      {
+      // Do nothing;
+      };
+
+
+template < class T >
+   void UndoLog < T >::record( unsigned int index )
+      {
+      this->records.push_back( std::make_pair( index, this->components->at( index ) ) );
+      };
+
+
+template < class T >
+   unsigned int UndoLog < T >::getCount() const
+      {
+      return this->records.size();
+      };
+
+
+template < class T >
+   void UndoLog < T >::rollback( unsigned int count )
+      {
+      // Restore in reverse order, so the oldest value of component wins;
+      while ( this->records.size() > count )
+         {
+         this->components->at( this->records.back().first ) = this->records.back().second;
+         this->records.pop_back();
+         }
+      };
+
+
+template < class T >
+   void UndoLog < T >::clear()
+      {
+      this->records.clear();
+      };
+
+
+#endif
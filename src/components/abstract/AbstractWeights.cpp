@@ -29,7 +29,7 @@
 AbstractWeights::AbstractWeights( unsigned int count )
    : ComponentsSet < double >::ComponentsSet( count )
    {
-   // Do nothing;
+   this->epoch = 0;
    };
 
 
@@ -39,6 +39,42 @@ AbstractWeights::~AbstractWeights()
    };
 
 
+void AbstractWeights::markFaulted( unsigned int index )
+   {
+   this->faulted.push_back( index );
+   };
+
+
+void AbstractWeights::clearFaulted()
+   {
+   this->faulted.clear();
+   };
+
+
+void AbstractWeights::truncateFaulted( unsigned int count )
+   {
+   if ( count < this->faulted.size() ) this->faulted.resize( count );
+   };
+
+
+const std::vector< unsigned int > & AbstractWeights::getFaulted() const
+   {
+   return this->faulted;
+   };
+
+
+void AbstractWeights::touch()
+   {
+   this->epoch ++;
+   };
+
+
+unsigned int AbstractWeights::getEpoch() const
+   {
+   return this->epoch;
+   };
+
+
 /***************************************************************************
  *   AbstractWeightsManager class implementation                           *
  ***************************************************************************/
@@ -60,7 +96,8 @@ AbstractWeightsManager::AbstractWeightsManager(
       ( abstractWeights != NULL ) ? abstractWeights->count() : 0,
       false,
       distribution
-      )
+      ),
+   undoLog( abstractWeights )
    {
    this->abstractWeights = abstractWeights;
 
@@ -69,28 +106,8 @@ AbstractWeightsManager::AbstractWeightsManager(
 
    this->fixFunction = fixFunction;
 
-   if ( fixFunction != NULL )
-      {
-      fixFunction->capture();
-      backup = NULL;
-      }
-   else
-      {
-      // Create backup;
-      unsigned int backupLength = abstractWeights->count();
-      if ( backupLength > 0 )
-         {
-         backup = new double[ backupLength ];
-         for ( unsigned int i = 0; i < backupLength; i ++ )
-            {
-            backup[ i ] = abstractWeights->at( i );
-            }
-         }
-      else
-         {
-         backup = NULL;
-         }
-      }
+   // Capture object;
+   if ( fixFunction != NULL ) fixFunction->capture();
    };
 
 
@@ -99,8 +116,6 @@ AbstractWeightsManager::~AbstractWeightsManager()
    // Release captured object;
    if ( abstractWeights != NULL ) abstractWeights->release();
    if ( fixFunction != NULL ) fixFunction->release();
-
-   if ( backup != NULL ) delete[] backup;
    };
 
 
@@ -108,7 +123,9 @@ void AbstractWeightsManager::simulateInterrupt( unsigned int intSource )
    {
    if ( intSource < intSourcesCount && abstractWeights != NULL )
       {
+      undoLog.record( intSource );
       abstractWeights->at( intSource ) = 0.0;
+      abstractWeights->markFaulted( intSource );
       }
    };
 
@@ -119,7 +136,10 @@ void AbstractWeightsManager::handleInterrupt()
    int weightIndex = getIntSource();
    if ( weightIndex >= 0 && abstractWeights != NULL )
       {
+      stateChanged = ( abstractWeights->at( weightIndex ) != 0.0 );
+      undoLog.record( weightIndex );
       abstractWeights->at( weightIndex ) = 0.0;
+      abstractWeights->markFaulted( weightIndex );
       }
 
    // Pass control to base implementation;
@@ -132,16 +152,33 @@ void AbstractWeightsManager::reinit()
    // Call base implementation;
    InterruptManager::reinit();
 
+   if ( abstractWeights != NULL ) abstractWeights->clearFaulted();
+
    if ( fixFunction != NULL )
       {
+      // Fixed weights are not the ones before faults;
+      undoLog.clear();
       fixFunction->call();
+      if ( abstractWeights != NULL ) abstractWeights->touch();
       }
    else
       {
-      // Restore weights from backup;
-      for ( unsigned int i = 0; i < abstractWeights->count(); i ++ )
-         {
-         abstractWeights->at( i ) = backup[ i ];
-         }
+      // Restore faulted components only;
+      undoLog.rollback();
       }
    };
+
+
+unsigned int AbstractWeightsManager::getUndoMark()
+   {
+   return undoLog.getCount();
+   };
+
+
+void AbstractWeightsManager::undoToMark( unsigned int mark )
+   {
+   undoLog.rollback( mark );
+
+   // Journal of faults follows undo log;
+   if ( abstractWeights != NULL ) abstractWeights->truncateFaulted( mark );
+   };
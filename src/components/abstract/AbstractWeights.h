@@ -22,7 +22,11 @@
 #define ABSTRACTWEIGHTS_H
 
 
+#include <vector>
+
+
 #include "components/ComponentsSet.h"
+#include "components/UndoLog.h"
 #include "engine/InterruptManager.h"
 #include "objects/CustomFunction.h"
 
@@ -37,6 +41,24 @@ class AbstractWeights : public ComponentsSet < double >
    public:
       AbstractWeights( unsigned int count = 0 );
       virtual ~AbstractWeights();
+
+      // Faulted weights are journaled until manager restores them, so
+      // networks recompute only the neurons depending on them;
+      void markFaulted( unsigned int index );
+      void clearFaulted();
+
+      // Forgets faults after the first count of them, which were undone;
+      void truncateFaulted( unsigned int count );
+      const std::vector< unsigned int > & getFaulted() const;
+
+      // Epoch is increased by every other change of weights, which makes
+      // results computed for previous weights out of date;
+      void touch();
+      unsigned int getEpoch() const;
+
+   private:
+      std::vector< unsigned int > faulted;
+      unsigned int epoch;
    };
 
 
@@ -61,10 +83,15 @@ class AbstractWeightsManager : public InterruptManager
       virtual void handleInterrupt();
       virtual void reinit();
 
+      virtual unsigned int getUndoMark();
+      virtual void undoToMark( unsigned int mark );
+
    private:
       AbstractWeights * abstractWeights;
       CustomFunction * fixFunction;
-      double * backup;
+
+      // Faulted components are restored from undo log on reinit;
+      UndoLog < double > undoLog;
    };
 
 
@@ -60,7 +60,8 @@ AnalogCapacitorsManager::AnalogCapacitorsManager(
       ( analogCapacitors != NULL ) ? analogCapacitors->count() : 0,
       false,
       distribution
-      )
+      ),
+   undoLog( analogCapacitors )
    {
    this->analogCapacitors = analogCapacitors;
 
@@ -69,28 +70,8 @@ AnalogCapacitorsManager::AnalogCapacitorsManager(
 
    this->fixFunction = fixFunction;
 
-   if ( fixFunction != NULL )
-      {
-      fixFunction->capture();
-      backup = NULL;
-      }
-   else
-      {
-      // Create backup;
-      unsigned int backupLength = analogCapacitors->count();
-      if ( backupLength > 0 )
-         {
-         backup = new double[ backupLength ];
-         for ( unsigned int i = 0; i < backupLength; i ++ )
-            {
-            backup[ i ] = analogCapacitors->at( i );
-            }
-         }
-      else
-         {
-         backup = NULL;
-         }
-      }
+   // Capture object;
+   if ( fixFunction != NULL ) fixFunction->capture();
    };
 
 
@@ -99,8 +80,6 @@ AnalogCapacitorsManager::~AnalogCapacitorsManager()
    // Release captured object;
    if ( analogCapacitors != NULL ) analogCapacitors->release();
    if ( fixFunction != NULL ) fixFunction->release();
-
-   if ( backup != NULL ) delete[] backup;
    };
 
 
@@ -108,6 +87,7 @@ void AnalogCapacitorsManager::simulateInterrupt( unsigned int intSource )
    {
    if ( intSource < intSourcesCount && analogCapacitors != NULL )
       {
+      undoLog.record( intSource );
       analogCapacitors->at( intSource ) = 0.0;
       }
    };
@@ -119,6 +99,8 @@ void AnalogCapacitorsManager::handleInterrupt()
    int capacitorIndex = getIntSource();
    if ( capacitorIndex >= 0 && analogCapacitors != NULL )
       {
+      stateChanged = ( analogCapacitors->at( capacitorIndex ) != 0.0 );
+      undoLog.record( capacitorIndex );
       analogCapacitors->at( capacitorIndex ) = 0.0;
       }
 
@@ -134,14 +116,24 @@ void AnalogCapacitorsManager::reinit()
 
    if ( fixFunction != NULL )
       {
+      undoLog.clear();
       fixFunction->call();
       }
    else
       {
-      // Restore capacitances from backup;
-      for ( unsigned int i = 0; i < analogCapacitors->count(); i ++ )
-         {
-         analogCapacitors->at( i ) = backup[ i ];
-         }
+      // Restore faulted components only;
+      undoLog.rollback();
       }
    };
+
+
+unsigned int AnalogCapacitorsManager::getUndoMark()
+   {
+   return undoLog.getCount();
+   };
+
+
+void AnalogCapacitorsManager::undoToMark( unsigned int mark )
+   {
+   undoLog.rollback( mark );
+   };
@@ -23,6 +23,7 @@
 
 
 #include "components/ComponentsSet.h"
+#include "components/UndoLog.h"
 #include "engine/InterruptManager.h"
 #include "objects/CustomFunction.h"
 
@@ -61,10 +62,15 @@ class AnalogCapacitorsManager : public InterruptManager
       virtual void handleInterrupt();
       virtual void reinit();
 
+      virtual unsigned int getUndoMark();
+      virtual void undoToMark( unsigned int mark );
+
    private:
       AnalogCapacitors * analogCapacitors;
       CustomFunction * fixFunction;
-      double * backup;
+
+      // Faulted components are restored from undo log on reinit;
+      UndoLog < double > undoLog;
    };
 
 
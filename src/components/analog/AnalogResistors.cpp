@@ -60,7 +60,8 @@ AnalogResistorsManager::AnalogResistorsManager(
       ( analogResistors != NULL ) ? analogResistors->count() : 0,
       false,
       distribution
-      )
+      ),
+   undoLog( analogResistors )
    {
    this->analogResistors = analogResistors;
 
@@ -69,28 +70,8 @@ AnalogResistorsManager::AnalogResistorsManager(
 
    this->fixFunction = fixFunction;
 
-   if ( fixFunction != NULL )
-      {
-      fixFunction->capture();
-      backup = NULL;
-      }
-   else
-      {
-      // Create backup;
-      unsigned int backupLength = analogResistors->count();
-      if ( backupLength > 0 )
-         {
-         backup = new double[ backupLength ];
-         for ( unsigned int i = 0; i < backupLength; i ++ )
-            {
-            backup[ i ] = analogResistors->at( i );
-            }
-         }
-      else
-         {
-         backup = NULL;
-         }
-      }
+   // Capture object;
+   if ( fixFunction != NULL ) fixFunction->capture();
    };
 
 
@@ -99,8 +80,6 @@ AnalogResistorsManager::~AnalogResistorsManager()
    // Release captured object;
    if ( analogResistors != NULL ) analogResistors->release();
    if ( fixFunction != NULL ) fixFunction->release();
-
-   if ( backup != NULL ) delete[] backup;
    };
 
 
@@ -108,6 +87,7 @@ void AnalogResistorsManager::simulateInterrupt( unsigned int intSource )
    {
    if ( intSource < intSourcesCount && analogResistors != NULL )
       {
+      undoLog.record( intSource );
       analogResistors->at( intSource ) = 0.0;
       }
    };
@@ -119,6 +99,8 @@ void AnalogResistorsManager::handleInterrupt()
    int resistorIndex = getIntSource();
    if ( resistorIndex >= 0 && analogResistors != NULL )
       {
+      stateChanged = ( analogResistors->at( resistorIndex ) != 0.0 );
+      undoLog.record( resistorIndex );
       analogResistors->at( resistorIndex ) = 0.0;
       }
 
@@ -134,14 +116,24 @@ void AnalogResistorsManager::reinit()
 
    if ( fixFunction != NULL )
       {
+      undoLog.clear();
       fixFunction->call();
       }
    else
       {
-      // Restore resistances from backup;
-      for ( unsigned int i = 0; i < analogResistors->count(); i ++ )
-         {
-         analogResistors->at( i ) = backup[ i ];
-         }
+      // Restore faulted components only;
+      undoLog.rollback();
       }
    };
+
+
+unsigned int AnalogResistorsManager::getUndoMark()
+   {
+   return undoLog.getCount();
+   };
+
+
+void AnalogResistorsManager::undoToMark( unsigned int mark )
+   {
+   undoLog.rollback( mark );
+   };
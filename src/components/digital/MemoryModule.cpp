@@ -60,7 +60,8 @@ MemoryModuleManager::MemoryModuleManager(
       ( memoryModule != NULL ) ? memoryModule->count() * 64 : 0,
       false,
       distribution
-      )
+      ),
+   undoLog( memoryModule )
    {
    this->memoryModule = memoryModule;
 
@@ -69,28 +70,8 @@ MemoryModuleManager::MemoryModuleManager(
 
    this->fixFunction = fixFunction;
 
-   if ( fixFunction != NULL )
-      {
-      fixFunction->capture();
-      backup = NULL;
-      }
-   else
-      {
-      // Create backup;
-      unsigned backupLength = memoryModule->count();
-      if ( backupLength > 0 )
-         {
-         backup = new double[ backupLength ];
-         for ( unsigned int i = 0; i < backupLength; i ++ )
-            {
-            backup[ i ] = memoryModule->at( i );
-            }
-         }
-      else
-         {
-         backup = NULL;
-         }
-      }
+   // Capture object;
+   if ( fixFunction != NULL ) fixFunction->capture();
    };
 
 
@@ -99,8 +80,6 @@ MemoryModuleManager::~MemoryModuleManager()
    // Release captured object;
    if ( memoryModule != NULL ) memoryModule->release();
    if ( fixFunction != NULL ) fixFunction->release();
-
-   if ( backup != NULL ) delete[] backup;
    };
 
 
@@ -111,6 +90,7 @@ void MemoryModuleManager::simulateInterrupt( unsigned int intSource )
       unsigned int wordIndex = intSource / 64;
       unsigned int bitInWordIndex = intSource % 64;
       unsigned char mask = ~ ( 0x01 << ( 7 - bitInWordIndex % 8 ) );
+      undoLog.record( wordIndex );
       double word = memoryModule->at( wordIndex );
       ( ( unsigned char * ) & word )[ bitInWordIndex / 8 ] &= mask;
       memoryModule->at( wordIndex ) = word;
@@ -127,8 +107,11 @@ void MemoryModuleManager::handleInterrupt()
       unsigned int wordIndex = bitIndex / 64;
       unsigned int bitInWordIndex = bitIndex % 64;
       unsigned char mask = ~ ( 0x01 << ( 7 - bitInWordIndex % 8 ) );
+      undoLog.record( wordIndex );
       double word = memoryModule->at( wordIndex );
-      ( ( unsigned char * ) & word )[ bitInWordIndex / 8 ] &= mask;
+      unsigned char & byte = ( ( unsigned char * ) & word )[ bitInWordIndex / 8 ];
+      stateChanged = ( ( byte & ~ mask ) != 0 );
+      byte &= mask;
       memoryModule->at( wordIndex ) = word;
       }
 
@@ -144,14 +127,24 @@ void MemoryModuleManager::reinit()
 
    if ( fixFunction != NULL )
       {
+      undoLog.clear();
       fixFunction->call();
       }
    else
       {
-      // Restore words from backup;
-      for ( unsigned int i = 0; i < memoryModule->count(); i ++ )
-         {
-         memoryModule->at( i ) = backup[ i ];
-         }
+      // Restore faulted components only;
+      undoLog.rollback();
       }
    };
+
+
+unsigned int MemoryModuleManager::getUndoMark()
+   {
+   return undoLog.getCount();
+   };
+
+
+void MemoryModuleManager::undoToMark( unsigned int mark )
+   {
+   undoLog.rollback( mark );
+   };
@@ -0,0 +1,242 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#include "engine/IndexedHeap.h"
+
+
+#include <stddef.h>
+
+
+/***************************************************************************
+ *   IndexedHeap class implementation                                      *
+ ***************************************************************************/
+
+
+IndexedHeap::IndexedHeap( unsigned int count, bool lastFirst )
+   {
+   this->count = count;
+   this->size = 0;
+   this->lastFirst = lastFirst;
+
+   if ( count > 0 )
+      {
+      this->keys = new double[ count ];
+      this->heap = new unsigned int[ count ];
+      this->positions = new int[ count ];
+
+      for ( unsigned int i = 0; i < count; i ++ )
+         {
+         this->keys[ i ] = -1.0;
+         this->positions[ i ] = -1;
+         }
+      }
+   else
+      {
+      this->keys = NULL;
+      this->heap = NULL;
+      this->positions = NULL;
+      }
+   };
+
+
+IndexedHeap::~IndexedHeap()
+   {
+   if ( this->keys != NULL ) delete[] this->keys;
+   if ( this->heap != NULL ) delete[] this->heap;
+   if ( this->positions != NULL ) delete[] this->positions;
+   };
+
+
+unsigned int IndexedHeap::getCount() const
+   {
+   return this->count;
+   };
+
+
+unsigned int IndexedHeap::getSize() const
+   {
+   return this->size;
+   };
+
+
+double * IndexedHeap::getKeys()
+   {
+   return this->keys;
+   };
+
+
+double IndexedHeap::getKey( unsigned int element ) const
+   {
+   return this->keys[ element ];
+   };
+
+
+void IndexedHeap::swapKeys( double *& keys )
+   {
+   double * swap = this->keys;
+   this->keys = keys;
+   keys = swap;
+
+   this->build();
+   };
+
+
+void IndexedHeap::build()
+   {
+   this->size = 0;
+
+   // Collect unmasked elements;
+   for ( unsigned int i = 0; i < this->count; i ++ )
+      {
+      if ( this->keys[ i ] >= 0.0 )
+         {
+         this->place( this->size, i );
+         this->size ++;
+         }
+      else
+         {
+         this->positions[ i ] = -1;
+         }
+      }
+
+   // Heapify bottom-up;
+   for ( int i = this->size / 2 - 1; i >= 0; i -- )
+      {
+      this->siftDown( i );
+      }
+   };
+
+
+int IndexedHeap::getTop() const
+   {
+   return ( this->size > 0 ) ? ( int ) this->heap[ 0 ] : -1;
+   };
+
+
+double IndexedHeap::getTopKey() const
+   {
+   return ( this->size > 0 ) ? this->keys[ this->heap[ 0 ] ] : -1.0;
+   };
+
+
+void IndexedHeap::update( unsigned int element, double key )
+   {
+   if ( element >= this->count ) return;
+
+   if ( key < 0.0 )
+      {
+      this->mask( element );
+      return;
+      }
+
+   int position = this->positions[ element ];
+   double oldKey = this->keys[ element ];
+   this->keys[ element ] = key;
+
+   if ( position < 0 )
+      {
+      // Insert element at the bottom;
+      this->place( this->size, element );
+      this->size ++;
+      this->siftUp( this->size - 1 );
+      }
+   else if ( key < oldKey )
+      {
+      this->siftUp( position );
+      }
+   else
+      {
+      this->siftDown( position );
+      }
+   };
+
+
+void IndexedHeap::mask( unsigned int element )
+   {
+   if ( element >= this->count ) return;
+
+   int position = this->positions[ element ];
+   this->keys[ element ] = -1.0;
+   if ( position < 0 ) return;
+
+   this->positions[ element ] = -1;
+   this->size --;
+
+   // Move the last element into the hole;
+   if ( ( unsigned int ) position < this->size )
+      {
+      this->place( position, this->heap[ this->size ] );
+      this->siftUp( position );
+      this->siftDown( this->positions[ this->heap[ position ] ] );
+      }
+   };
+
+
+inline bool IndexedHeap::isLess( unsigned int a, unsigned int b ) const
+   {
+   return ( this->keys[ a ] < this->keys[ b ] ||
+      ( this->keys[ a ] == this->keys[ b ] && ( ( this->lastFirst ) ? a > b : a < b ) )
+      );
+   };
+
+
+inline void IndexedHeap::place( unsigned int position, unsigned int element )
+   {
+   this->heap[ position ] = element;
+   this->positions[ element ] = position;
+   };
+
+
+void IndexedHeap::siftUp( unsigned int position )
+   {
+   unsigned int element = this->heap[ position ];
+
+   while ( position > 0 )
+      {
+      unsigned int parent = ( position - 1 ) / 2;
+      if ( ! this->isLess( element, this->heap[ parent ] ) ) break;
+
+      this->place( position, this->heap[ parent ] );
+      position = parent;
+      }
+
+   this->place( position, element );
+   };
+
+
+void IndexedHeap::siftDown( unsigned int position )
+   {
+   unsigned int element = this->heap[ position ];
+
+   while ( true )
+      {
+      unsigned int child = 2 * position + 1;
+      if ( child >= this->size ) break;
+
+      // Choose the least child;
+      if ( child + 1 < this->size && this->isLess( this->heap[ child + 1 ], this->heap[ child ] ) ) child ++;
+      if ( ! this->isLess( this->heap[ child ], element ) ) break;
+
+      this->place( position, this->heap[ child ] );
+      position = child;
+      }
+
+   this->place( position, element );
+   };
@@ -0,0 +1,82 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#ifndef INDEXEDHEAP_H
+#define INDEXEDHEAP_H
+
+
+/***************************************************************************
+ *   IndexedHeap class declaration                                         *
+ ***************************************************************************/
+
+
+// Binary min-heap over elements 0 .. count - 1 keyed by their times.
+// Position of every element is tracked, so key of any element can be
+// changed in O( log n ). Negative key means element is masked and is not
+// kept in heap. Equal keys are ordered by element index, the last
+// element goes first if lastFirst is set;
+class IndexedHeap
+   {
+   public:
+      IndexedHeap( unsigned int count = 0, bool lastFirst = false );
+      virtual ~IndexedHeap();
+
+      unsigned int getCount() const;
+      unsigned int getSize() const;
+
+      // Keys may be written directly, build() must be called after that;
+      double * getKeys();
+      double getKey( unsigned int element ) const;
+
+      // Swaps array of count keys with internal one and rebuilds heap;
+      void swapKeys( double *& keys );
+
+      // Rebuilds heap from keys in O( n );
+      void build();
+
+      // Returns element with minimal key or -1 if heap is empty;
+      int getTop() const;
+      double getTopKey() const;
+
+      // Changes key of element, negative key masks element;
+      void update( unsigned int element, double key );
+      void mask( unsigned int element );
+
+   private:
+      IndexedHeap( const IndexedHeap & other );
+      IndexedHeap & operator =( const IndexedHeap & other );
+
+      inline bool isLess( unsigned int a, unsigned int b ) const;
+      inline void place( unsigned int position, unsigned int element );
+
+      void siftUp( unsigned int position );
+      void siftDown( unsigned int position );
+
+      unsigned int count;
+      unsigned int size;
+      bool lastFirst;
+
+      double * keys;
+      unsigned int * heap;
+      int * positions;
+   };
+
+
+#endif
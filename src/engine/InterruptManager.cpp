@@ -21,6 +21,11 @@
 #include "engine/InterruptManager.h"
 
 
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+
+
 /***************************************************************************
  *   InterruptManager abstract class implementation                        *
  ***************************************************************************/
@@ -35,13 +40,16 @@ InterruptManager::InterruptManager(
    // Clear interrupts counter;
    this->interruptsCount = 0;
 
+   // Interrupts are assumed to change components;
+   this->stateChanged = true;
+
    // Initialize interrupts array with NULL;
    this->interrupts = NULL;
 
    // Try to allocate memory for interrupts;
    if ( intSourcesCount > 0 )
       {
-      this->interrupts = new double[ intSourcesCount ];
+      this->interrupts = new IndexedHeap( intSourcesCount );
       }
 
    if ( this->interrupts != NULL )
@@ -58,11 +66,34 @@ InterruptManager::InterruptManager(
       // Capture object;
       if ( distribution != NULL ) distribution->capture();
 
+      // Nothing is preloaded yet;
+      this->preloaded = false;
+
+      // Interrupts of all the sources are sampled by default;
+      this->lazySampling = false;
+      this->survivors = NULL;
+      this->survivorsCount = 0;
+      this->lazyIntSource = -1;
+      this->lazyInterrupt = -1.0;
+
+      // Original distribution is sampled by default;
+      this->bias = 1.0;
+      this->logBias = 0.0;
+      this->logFailuresRatio = 0.0;
+
+      // Interrupts are pseudo-random until engine assigns sampling plan;
+      this->plan = NULL;
+      this->dimension = 0;
+
+      // Seed is taken from the global generator until engine assigns
+      // stream to manager;
+      this->generator.setStream( rand(), 0, 0 );
+
       // Generate interrupts;
-      for ( unsigned int i = 0; i < intSourcesCount; i ++ )
-         {
-         this->interrupts[ i ] = this->distribution->generateTime();
-         }
+      double * times = this->interrupts->getKeys();
+      this->distribution->generateTimes( this->generator, intSourcesCount, times );
+
+      this->interrupts->build();
 
       // Clear int source;
       this->intSource = -1;
@@ -77,23 +108,38 @@ InterruptManager::InterruptManager(
       this->lastIntSource = -1;
       this->unlimitedRegeneration = false;
       this->distribution = NULL;
+      this->preloaded = false;
+      this->lazySampling = false;
+      this->survivors = NULL;
+      this->survivorsCount = 0;
+      this->lazyIntSource = -1;
+      this->lazyInterrupt = -1.0;
+      this->bias = 1.0;
+      this->logBias = 0.0;
+      this->logFailuresRatio = 0.0;
+      this->plan = NULL;
+      this->dimension = 0;
       }
    };
 
 
 InterruptManager::~InterruptManager()
    {
-   // Delete interrupts array;
-   if ( this->interrupts != NULL ) delete[] this->interrupts;
+   // Delete interrupts heap;
+   if ( this->interrupts != NULL ) delete this->interrupts;
+   if ( this->survivors != NULL ) delete[] this->survivors;
 
    // Release captured object;
    if ( this->distribution != NULL ) this->distribution->release();
+   if ( this->plan != NULL ) this->plan->release();
    };
 
 
 double InterruptManager::getInterrupt()
    {
-   return ( ( this->intSource >= 0 ) ? this->interrupts[ this->intSource ] : -1.0 );
+   if ( this->intSource < 0 ) return -1.0;
+
+   return ( this->lazySampling ) ? this->lazyInterrupt : this->interrupts->getKey( this->intSource );
    };
 
 
@@ -103,6 +149,12 @@ int InterruptManager::getLastIntSource()
    };
 
 
+bool InterruptManager::isStateChanged() const
+   {
+   return this->stateChanged;
+   };
+
+
 int InterruptManager::getIntSource()
    {
    return this->intSource;
@@ -121,19 +173,289 @@ unsigned int InterruptManager::getInterruptsCount() const
    };
 
 
+Distribution * InterruptManager::getDistribution()
+   {
+   return distribution;
+   };
+
+
+bool InterruptManager::setDistribution( Distribution * distribution )
+   {
+   if ( this->intSourcesCount == 0 || distribution == NULL ) return false;
+
+   // Capture object;
+   distribution->capture();
+
+   // Release captured object;
+   this->distribution->release();
+
+   this->distribution = distribution;
+
+   if ( this->lazySampling &&
+      dynamic_cast < ExponentialDistribution * >( distribution ) == NULL
+      )
+      {
+      this->setLazySampling( false );
+      }
+
+   if ( this->bias != 1.0 && ! distribution->hasDensity() )
+      {
+      this->bias = 1.0;
+      this->logBias = 0.0;
+      }
+
+   this->preloaded = false;
+
+   // Resample current replica;
+   this->interruptsCount = 0;
+   this->logFailuresRatio = 0.0;
+   this->sampleInterrupts();
+   this->intSource = -1;
+   this->findOutIntSource();
+
+   return true;
+   };
+
+
+void InterruptManager::setRandomStream( uint64_t seed, uint32_t replica, uint32_t stream )
+   {
+   this->generator.setStream( seed, replica, stream );
+   };
+
+
+void InterruptManager::resampleInterrupts( double time )
+   {
+   if ( this->lazySampling )
+      {
+      // Exponential lifetimes have no memory;
+      this->lazyInterrupt = time;
+      this->sampleLazyInterrupt();
+      }
+   else if ( this->interrupts != NULL )
+      {
+      // Masked sources have already failed;
+      double * times = this->interrupts->getKeys();
+      for ( unsigned int i = 0; i < this->intSourcesCount; i ++ )
+         {
+         if ( times[ i ] >= 0.0 ) times[ i ] = this->distribution->generateTimeAfter( this->generator, time );
+         }
+
+      this->interrupts->build();
+      }
+
+   // Handled interrupt stays the last one;
+   int lastIntSource = this->lastIntSource;
+   this->findOutIntSource();
+   this->lastIntSource = lastIntSource;
+   };
+
+
+void InterruptManager::setSamplingPlan( SamplingPlan * plan, uint32_t dimension )
+   {
+   // Capture object;
+   if ( plan != NULL ) plan->capture();
+
+   // Release captured object;
+   if ( this->plan != NULL ) this->plan->release();
+
+   this->plan = plan;
+   this->dimension = dimension;
+   };
+
+
+SamplingPlan * InterruptManager::getSamplingPlan()
+   {
+   return this->plan;
+   };
+
+
+void InterruptManager::preloadInterrupts( double *& interrupts )
+   {
+   if ( this->interrupts == NULL || this->lazySampling ) return;
+
+   // Replica runner samples original distribution;
+   if ( this->bias != 1.0 )
+      {
+      for ( unsigned int i = 0; i < this->intSourcesCount; i ++ ) interrupts[ i ] /= this->bias;
+      }
+
+   double * swap = this->interrupts->getKeys();
+   this->interrupts->swapKeys( interrupts );
+   interrupts = swap;
+
+   this->preloaded = true;
+   };
+
+
+bool InterruptManager::setLazySampling( bool lazySampling )
+   {
+   if ( this->intSourcesCount == 0 ) return false;
+
+   if ( lazySampling &&
+      ( this->unlimitedRegeneration ||
+      dynamic_cast < ExponentialDistribution * >( this->distribution ) == NULL )
+      )
+      {
+      lazySampling = false;
+      }
+
+   if ( lazySampling == this->lazySampling ) return lazySampling;
+
+   this->lazySampling = lazySampling;
+   this->preloaded = false;
+
+   if ( lazySampling )
+      {
+      // Interrupts of sources are not stored any more;
+      delete this->interrupts;
+      this->interrupts = NULL;
+
+      this->survivors = new unsigned int[ this->intSourcesCount ];
+      for ( unsigned int i = 0; i < this->intSourcesCount; i ++ ) this->survivors[ i ] = i;
+      this->survivorsSwaps.clear();
+      }
+   else
+      {
+      delete[] this->survivors;
+      this->survivors = NULL;
+
+      this->interrupts = new IndexedHeap( this->intSourcesCount );
+      }
+
+   // Resample current replica;
+   this->interruptsCount = 0;
+   this->sampleInterrupts();
+   this->intSource = -1;
+   this->findOutIntSource();
+
+   return lazySampling;
+   };
+
+
+double InterruptManager::getOrderedInterrupt( unsigned int k )
+   {
+   if ( this->lazySampling ||
+      this->unlimitedRegeneration ||
+      this->interrupts == NULL ||
+      k == 0 ||
+      k > this->intSourcesCount
+      ) return -1.0;
+
+   std::vector< double > times(
+      this->interrupts->getKeys(),
+      this->interrupts->getKeys() + this->intSourcesCount
+      );
+
+   std::nth_element( times.begin(), times.begin() + k - 1, times.end() );
+   return times[ k - 1 ];
+   };
+
+
+bool InterruptManager::isUnlimitedRegeneration() const
+   {
+   return this->unlimitedRegeneration;
+   };
+
+
+bool InterruptManager::isLazySampling() const
+   {
+   return this->lazySampling;
+   };
+
+
+bool InterruptManager::setBias( double bias )
+   {
+   if ( this->intSourcesCount == 0 || ! ( bias > 0.0 ) ) return false;
+
+   if ( bias != 1.0 &&
+      ( this->unlimitedRegeneration || ! this->distribution->hasDensity() )
+      )
+      {
+      return false;
+      }
+
+   this->bias = bias;
+   this->logBias = log( bias );
+   this->preloaded = false;
+
+   // Resample current replica;
+   this->interruptsCount = 0;
+   this->logFailuresRatio = 0.0;
+   this->sampleInterrupts();
+   this->intSource = -1;
+   this->findOutIntSource();
+
+   return true;
+   };
+
+
+double InterruptManager::getBias() const
+   {
+   return this->bias;
+   };
+
+
+double InterruptManager::getLogLikelihoodRatio( double time )
+   {
+   if ( this->bias == 1.0 ) return 0.0;
+
+   // Survivors have not failed neither in original nor in biased time;
+   double survivorsCount = this->intSourcesCount - this->interruptsCount;
+   double logSurvivorRatio =
+      this->distribution->logSurvival( time ) -
+      this->distribution->logSurvival( this->bias * time );
+
+   return this->logFailuresRatio + survivorsCount * logSurvivorRatio;
+   };
+
+
+void InterruptManager::attachObserver( InterruptObserver * observer, unsigned int slot )
+   {
+   this->observers.push_back( std::make_pair( observer, slot ) );
+   };
+
+
+void InterruptManager::detachObserver( InterruptObserver * observer )
+   {
+   for ( int i = this->observers.size() - 1; i >= 0; i -- )
+      {
+      if ( this->observers[ i ].first == observer )
+         {
+         this->observers.erase( this->observers.begin() + i );
+         }
+      }
+   };
+
+
 void InterruptManager::handleInterrupt()
    {
    if ( this->intSource >= 0 )
       {
-      if ( this->unlimitedRegeneration )
+      if ( this->bias != 1.0 )
+         {
+         // Biased density is bias * f( bias * t );
+         double t = this->getInterrupt();
+         this->logFailuresRatio +=
+            this->distribution->logDensity( t ) -
+            this->logBias -
+            this->distribution->logDensity( this->bias * t );
+         }
+
+      if ( this->lazySampling )
+         {
+         // Current source is the last survivor;
+         this->survivorsCount --;
+         this->sampleLazyInterrupt();
+         }
+      else if ( this->unlimitedRegeneration )
          {
          // Generate new interrupt for current source;
-         this->interrupts[ this->intSource ] = this->distribution->generateTime();
+         this->interrupts->update( this->intSource, this->distribution->generateTime( this->generator ) );
          }
       else
          {
          // Mask current source;
-         this->interrupts[ this->intSource ] = -1.0;
+         this->interrupts->mask( this->intSource );
          }
 
       // Increment interrupts counter;
@@ -149,11 +471,18 @@ void InterruptManager::reinit()
    {
    // Clear interrupts counter;
    this->interruptsCount = 0;
+   this->logFailuresRatio = 0.0;
 
-   // Generate interrupts;
-   for ( unsigned int i = 0; i < intSourcesCount; i ++ )
+   if ( this->preloaded )
       {
-      this->interrupts[ i ] = this->distribution->generateTime();
+      // Interrupts were sampled by replica runner from the same stream,
+      // so regenerated interrupts have to follow them;
+      this->generator.skipAhead( this->intSourcesCount );
+      this->preloaded = false;
+      }
+   else
+      {
+      this->sampleInterrupts();
       }
 
    // Clear int source;
@@ -175,33 +504,95 @@ void InterruptManager::findOutIntSource()
    // Store last interrupt source;
    this->lastIntSource = this->intSource;
 
-   double min = -1.0;
-   this->intSource = -1;
+   // Take the earliest unmasked source;
+   if ( this->lazySampling ) this->intSource = this->lazyIntSource;
+   else this->intSource = ( this->interrupts != NULL ) ? this->interrupts->getTop() : -1;
+
+   // Notify observers;
+   for ( unsigned int i = 0; i < this->observers.size(); i ++ )
+      {
+      this->observers[ i ].first->interruptChanged( this, this->observers[ i ].second );
+      }
+   };
 
-   unsigned int i = 0;
 
-   // Initialize minimum;
-   while ( i < intSourcesCount )
+void InterruptManager::sampleInterrupts()
+   {
+   if ( this->lazySampling )
       {
-      if ( this->interrupts[ i ] >= 0.0 )
+      // Undo swaps in reverse order, so survivors are in initial order;
+      while ( !this->survivorsSwaps.empty() )
          {
-         min = this->interrupts[ i ];
-         this->intSource = i;
-         break;
+         unsigned int a = this->survivorsSwaps.back().first;
+         unsigned int b = this->survivorsSwaps.back().second;
+         unsigned int survivor = this->survivors[ a ];
+         this->survivors[ a ] = this->survivors[ b ];
+         this->survivors[ b ] = survivor;
+         this->survivorsSwaps.pop_back();
          }
 
-      i ++;
+      this->survivorsCount = this->intSourcesCount;
+      this->lazyInterrupt = 0.0;
+      this->sampleLazyInterrupt();
       }
-
-   // Search for minimum;
-   while ( i < intSourcesCount )
+   else if ( this->interrupts != NULL )
       {
-      if ( this->interrupts[ i ] >= 0.0 && this->interrupts[ i ] < min )
+      // Generate interrupts;
+      double * times = this->interrupts->getKeys();
+      if ( this->plan != NULL )
+         {
+         this->distribution->generateTimes(
+            * this->plan,
+            this->generator.getSeed(),
+            this->generator.getReplica(),
+            this->dimension,
+            intSourcesCount,
+            times
+            );
+
+         // Regenerated interrupts follow the same position of stream as
+         // after preloaded ones;
+         this->generator.skipAhead( this->intSourcesCount );
+         }
+      else
+         {
+         this->distribution->generateTimes( this->generator, intSourcesCount, times );
+         }
+
+      if ( this->bias != 1.0 )
          {
-         min = this->interrupts[ i ];
-         this->intSource = i;
+         for ( unsigned int i = 0; i < this->intSourcesCount; i ++ ) times[ i ] /= this->bias;
          }
 
-      i ++;
+      this->interrupts->build();
       }
    };
+
+
+void InterruptManager::sampleLazyInterrupt()
+   {
+   if ( this->survivorsCount == 0 )
+      {
+      this->lazyIntSource = -1;
+      this->lazyInterrupt = -1.0;
+      return;
+      }
+
+   // Minimum of k exponential lifetimes is exponential with k times
+   // larger rate;
+   this->lazyInterrupt +=
+      this->distribution->generateTime( this->generator ) /
+      ( this->survivorsCount * this->bias );
+
+   // Choose failed source uniformly and move it to the end of survivors;
+   unsigned int last = this->survivorsCount - 1;
+   unsigned int index = ( unsigned int ) ( this->generator.generateUniform() * this->survivorsCount );
+   if ( index > last ) index = last;
+
+   unsigned int survivor = this->survivors[ index ];
+   this->survivors[ index ] = this->survivors[ last ];
+   this->survivors[ last ] = survivor;
+   if ( index != last ) this->survivorsSwaps.push_back( std::make_pair( index, last ) );
+
+   this->lazyIntSource = survivor;
+   };
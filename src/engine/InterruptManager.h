@@ -22,8 +22,33 @@
 #define INTERRUPTMANAGER_H
 
 
+#include <vector>
+
+
 #include "kernel/KernelObject.h"
+#include "engine/IndexedHeap.h"
 #include "math/Distribution.h"
+#include "math/RandomGenerator.h"
+#include "math/SamplingPlan.h"
+
+
+class InterruptManager;
+
+
+/***************************************************************************
+ *   InterruptObserver abstract class declaration                          *
+ ***************************************************************************/
+
+
+// Observer is notified every time the earliest interrupt of manager
+// changes. Slot is the value given to InterruptManager::attachObserver();
+class InterruptObserver
+   {
+   public:
+      virtual ~InterruptObserver() {};
+
+      virtual void interruptChanged( InterruptManager * manager, unsigned int slot ) = 0;
+   };
 
 
 /***************************************************************************
@@ -44,10 +69,76 @@ class InterruptManager : public KernelObject
 
       double getInterrupt();
       int getLastIntSource();
+
+      // False if the last handled interrupt left components unchanged,
+      // e.g. broke up a component which was already broken, so it can
+      // not change the result of test;
+      bool isStateChanged() const;
       int getIntSource();
       unsigned int getIntSourcesCount() const;
       unsigned int getInterruptsCount() const;
 
+      // Time of k-th interrupt of current replica, k = 1, ..., n, taken
+      // from interrupts sampled by reinit(), so it has to be called before
+      // they are handled. Negative if it is not known, e.g. in lazy mode
+      // or with regeneration;
+      double getOrderedInterrupt( unsigned int k );
+
+      // Without regeneration faults only accumulate;
+      bool isUnlimitedRegeneration() const;
+
+      Distribution * getDistribution();
+
+      // Replaces distribution and resamples current replica, lazy mode and
+      // bias are turned off if new distribution does not support them.
+      // Replicas prepared by engine runner are dropped only by the next
+      // engine reset, e.g. SimulationEngine::setSeed();
+      bool setDistribution( Distribution * distribution );
+
+      // Interrupts of the next reinit() are generated from the beginning
+      // of given stream;
+      void setRandomStream( uint64_t seed, uint32_t replica, uint32_t stream );
+
+      // Samples pending interrupts again from current stream, conditioned
+      // on being later than given time, which should be the time of the
+      // last interrupt. Sources must not regenerate nor be biased;
+      void resampleInterrupts( double time );
+
+      // Interrupts of the next reinit() are generated from coordinates
+      // dimension, ..., dimension + intSourcesCount - 1 of replica point
+      // of the plan, NULL plan restores pseudo-random sampling. Lazy mode
+      // and regenerated interrupts always use random stream;
+      void setSamplingPlan( SamplingPlan * plan, uint32_t dimension );
+      SamplingPlan * getSamplingPlan();
+
+      // Swaps array of pre-sampled interrupts with internal one, so the
+      // next reinit() call uses them instead of generating new;
+      void preloadInterrupts( double *& interrupts );
+
+      // In lazy mode only the next interrupt is sampled: for exponential
+      // lifetimes the first of k survivors fails at rate k * lambda and
+      // is chosen uniformly among them. Mode is available only for
+      // exponential distribution without regeneration, returns true if
+      // it is enabled. Interrupts of current replica are resampled;
+      bool setLazySampling( bool lazySampling );
+      bool isLazySampling() const;
+
+      // Importance sampling: lifetimes are divided by bias, so faults
+      // come bias times sooner, and replica is weighted by likelihood
+      // ratio of the original and biased distributions. Bias is available
+      // only for distributions with density and without regeneration,
+      // returns true if it is set. Interrupts of current replica are
+      // resampled;
+      bool setBias( double bias );
+      double getBias() const;
+
+      // Logarithm of likelihood ratio of events observed up to given
+      // time, which should not be less than the time of the last interrupt;
+      double getLogLikelihoodRatio( double time );
+
+      void attachObserver( InterruptObserver * observer, unsigned int slot );
+      void detachObserver( InterruptObserver * observer );
+
       virtual void simulateInterrupt( unsigned int intSource ) = 0;
 
       // Base method should be called at the end of reimplementation;
@@ -56,24 +147,64 @@ class InterruptManager : public KernelObject
       // Base method should be called in reimplementation;
       virtual void reinit() = 0;
 
+      // Components changed after the first mark changes of current replica
+      // are restored, so components can be inspected as they were after
+      // earlier interrupt, and simulateInterrupt() applies later ones again;
+      virtual unsigned int getUndoMark() = 0;
+      virtual void undoToMark( unsigned int mark ) = 0;
+
    protected:
       InterruptManager();
 
       unsigned int intSourcesCount;
 
+      // Should be set by handleInterrupt() of derived managers;
+      bool stateChanged;
+
    private:
-      // Most time-consuming operation;
       void findOutIntSource();
 
+      // Samples interrupts of the new replica;
+      void sampleInterrupts();
+
+      // Samples time and source of the next interrupt in lazy mode;
+      void sampleLazyInterrupt();
+
       unsigned int interruptsCount;
 
-      double * interrupts;
+      // Interrupts are kept in heap, so the earliest of them is found in
+      // O( 1 ) and masked or regenerated in O( log n );
+      IndexedHeap * interrupts;
 
       int intSource;
       int lastIntSource;
 
       bool unlimitedRegeneration;
       Distribution * distribution;
+      RandomGenerator generator;
+
+      SamplingPlan * plan;
+      uint32_t dimension;
+
+      bool preloaded;
+
+      // Survivors are kept in the first survivorsCount elements, swaps
+      // are undone on restart of replica, so the same replica fails the
+      // same sources;
+      bool lazySampling;
+      unsigned int * survivors;
+      unsigned int survivorsCount;
+      std::vector< std::pair< unsigned int, unsigned int > > survivorsSwaps;
+      int lazyIntSource;
+      double lazyInterrupt;
+
+      // Failed sources contribute to likelihood ratio as soon as they
+      // fail, survivors contribute on request;
+      double bias;
+      double logBias;
+      double logFailuresRatio;
+
+      std::vector< std::pair< InterruptObserver *, unsigned int > > observers;
    };
 
 
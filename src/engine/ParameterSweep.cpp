@@ -0,0 +1,203 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#include "engine/ParameterSweep.h"
+
+
+/***************************************************************************
+ *   ParameterSweep class implementation                                   *
+ ***************************************************************************/
+
+
+ParameterSweep::ParameterSweep(
+   SimulationEngine * engine,
+   CustomFunction * testFunction
+   )
+   {
+   this->engine = engine;
+   this->testFunction = testFunction;
+
+   if ( engine != NULL ) engine->capture();
+   if ( testFunction != NULL ) testFunction->capture();
+
+   this->estimator = ESTIMATOR::TIME_TO_FAIL;
+   this->time = 0.0;
+   this->manager = NULL;
+   this->intSource = 0;
+
+   // All the replicas are run by default;
+   this->precision = 0.0;
+   this->batchSize = 100;
+   };
+
+
+ParameterSweep::~ParameterSweep()
+   {
+   if ( engine != NULL ) engine->release();
+   if ( testFunction != NULL ) testFunction->release();
+   if ( manager != NULL ) manager->release();
+   };
+
+
+void ParameterSweep::setEstimator(
+   ESTIMATOR::T_ESTIMATOR estimator,
+   double time,
+   InterruptManager * manager,
+   unsigned int intSource
+   )
+   {
+   // Capture object;
+   if ( manager != NULL ) manager->capture();
+
+   // Release captured object;
+   if ( this->manager != NULL ) this->manager->release();
+
+   this->estimator = estimator;
+   this->time = time;
+   this->manager = manager;
+   this->intSource = intSource;
+   };
+
+
+void ParameterSweep::setPrecision( double precision, unsigned int batchSize )
+   {
+   this->precision = precision;
+   this->batchSize = batchSize;
+   };
+
+
+void ParameterSweep::run(
+   std::vector< Distribution * > & distributions,
+   unsigned int times,
+   std::vector< Estimate > & estimates
+   )
+   {
+   // Keep original distributions and lazy sampling flags to restore
+   // them after the sweep;
+   std::vector< Distribution * > originals;
+   std::vector< bool > lazyFlags;
+   for ( unsigned int i = 0; i < engine->getManagersCount(); i ++ )
+      {
+      InterruptManager * manager = engine->getManager( i );
+      Distribution * distribution = ( manager != NULL ) ? manager->getDistribution() : NULL;
+
+      // Capture object;
+      if ( distribution != NULL ) distribution->capture();
+
+      originals.push_back( distribution );
+      lazyFlags.push_back( manager != NULL && manager->isLazySampling() );
+      }
+
+   uint64_t seed = engine->getSeed();
+   ReliabilityEstimator reliabilityEstimator( engine, testFunction );
+   reliabilityEstimator.setPrecision( precision, batchSize );
+
+   try
+      {
+      estimates.clear();
+      for ( unsigned int i = 0; i < distributions.size(); i ++ )
+         {
+         std::vector< Distribution * > point( originals.size(), distributions[ i ] );
+         setDistributions( point );
+
+         // Every point starts from the first replica of the same streams;
+         engine->setSeed( seed );
+         reliabilityEstimator.setCheckpointTag( i + 1 );
+
+         switch ( estimator )
+            {
+            case ESTIMATOR::SURVIVAL_FUNCTION:
+               estimates.push_back( reliabilityEstimator.estimateSurvivalFunction( time, times ) );
+               break;
+            case ESTIMATOR::COMPONENT_IMPORTANCE:
+               estimates.push_back( reliabilityEstimator.estimateComponentImportance(
+                  time,
+                  times,
+                  manager,
+                  intSource
+                  ) );
+               break;
+            default:
+               estimates.push_back( reliabilityEstimator.estimateTimeToFail( times ) );
+               break;
+            }
+         }
+      }
+   catch ( CustomFunctionExcp & )
+      {
+      // Engine keeps original distributions after failed sweep;
+      restoreDistributions( originals, lazyFlags );
+      engine->setSeed( seed );
+      throw;
+      }
+
+   restoreDistributions( originals, lazyFlags );
+   engine->setSeed( seed );
+   };
+
+
+ParameterSweep::ParameterSweep()
+   {
+   // Do nothing;
+   };
+
+
+ParameterSweep::ParameterSweep( const ParameterSweep & other )
+   {
+   // Do nothing;
+   };
+
+
+ParameterSweep & ParameterSweep::operator =( const ParameterSweep & other )
+   {
+   // Do nothing;
+   return * this;
+   };
+
+
+void ParameterSweep::setDistributions( std::vector< Distribution * > & distributions )
+   {
+   for ( unsigned int i = 0; i < distributions.size(); i ++ )
+      {
+      InterruptManager * manager = engine->getManager( i );
+      if ( manager != NULL && distributions[ i ] != NULL ) manager->setDistribution( distributions[ i ] );
+      }
+   };
+
+
+void ParameterSweep::restoreDistributions(
+   std::vector< Distribution * > & originals,
+   std::vector< bool > & lazyFlags
+   )
+   {
+   setDistributions( originals );
+
+   for ( unsigned int i = 0; i < originals.size(); i ++ )
+      {
+      InterruptManager * manager = engine->getManager( i );
+      if ( manager != NULL && lazyFlags[ i ] && ! manager->isLazySampling() )
+         {
+         manager->setLazySampling( true );
+         }
+
+      // Release captured object;
+      if ( originals[ i ] != NULL ) originals[ i ]->release();
+      }
+   };
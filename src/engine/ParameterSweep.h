@@ -0,0 +1,111 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#ifndef PARAMETERSWEEP_H
+#define PARAMETERSWEEP_H
+
+
+#include <vector>
+
+
+#include "engine/ReliabilityEstimator.h"
+#include "engine/SimulationEngine.h"
+#include "math/Distribution.h"
+#include "objects/CustomFunction.h"
+
+
+/***************************************************************************
+ *   T_ESTIMATOR enum declaration                                          *
+ ***************************************************************************/
+
+namespace ESTIMATOR
+   {
+   enum T_ESTIMATOR
+      {
+      TIME_TO_FAIL,
+      SURVIVAL_FUNCTION,
+      COMPONENT_IMPORTANCE
+      };
+   };
+
+
+/***************************************************************************
+ *   ParameterSweep class declaration                                      *
+ ***************************************************************************/
+
+
+// Evaluates estimator at every point of distribution grid. Points share
+// engine and its managers, and every point restarts engine from the same
+// seed, so all the points take common random numbers. Distribution of
+// every manager of engine is replaced by the point, including managers
+// with custom distributions. Original distributions and lazy sampling
+// flags are restored after the sweep;
+class ParameterSweep
+   {
+   public:
+      ParameterSweep( SimulationEngine * engine, CustomFunction * testFunction );
+      virtual ~ParameterSweep();
+
+      // Time is used by survival function and component importance,
+      // manager and intSource by component importance only;
+      void setEstimator(
+         ESTIMATOR::T_ESTIMATOR estimator,
+         double time,
+         InterruptManager * manager,
+         unsigned int intSource
+         );
+
+      // The same as ReliabilityEstimator::setPrecision();
+      void setPrecision( double precision, unsigned int batchSize );
+
+      void run(
+         std::vector< Distribution * > & distributions,
+         unsigned int times,
+         std::vector< Estimate > & estimates
+         );
+
+   private:
+      ParameterSweep();
+      ParameterSweep( const ParameterSweep & other );
+      ParameterSweep & operator =( const ParameterSweep & other );
+
+      void setDistributions( std::vector< Distribution * > & distributions );
+
+      // Sets and releases original distributions captured by run(), then
+      // restores lazy sampling turned off by non-exponential points;
+      void restoreDistributions(
+         std::vector< Distribution * > & originals,
+         std::vector< bool > & lazyFlags
+         );
+
+      SimulationEngine * engine;
+      CustomFunction * testFunction;
+
+      ESTIMATOR::T_ESTIMATOR estimator;
+      double time;
+      InterruptManager * manager;
+      unsigned int intSource;
+
+      double precision;
+      unsigned int batchSize;
+   };
+
+
+#endif
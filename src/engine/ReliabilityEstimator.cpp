@@ -0,0 +1,1423 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#include "engine/ReliabilityEstimator.h"
+
+
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+
+
+#include "math/Statistics.h"
+
+
+// Checkpoint file starts with signature and version;
+static const char CHECKPOINT_SIGNATURE[ 4 ] = { 'N', 'W', 'C', 'P' };
+static const uint32_t CHECKPOINT_VERSION = 2;
+
+
+// Signal handler only records signal, checkpoint is saved by estimator
+// between replicas;
+static volatile sig_atomic_t caughtSignal = 0;
+
+
+static void catchSignal( int signal )
+   {
+   caughtSignal = signal;
+   };
+
+
+/***************************************************************************
+ *   ReliabilityEstimator class implementation                             *
+ ***************************************************************************/
+
+
+ReliabilityEstimator::ReliabilityEstimator(
+   SimulationEngine * engine,
+   CustomFunction * testFunction
+   )
+   {
+   this->engine = engine;
+   this->testFunction = testFunction;
+
+   if ( engine != NULL ) engine->capture();
+   if ( testFunction != NULL ) testFunction->capture();
+
+   // All the replicas are run by default;
+   this->precision = 0.0;
+   this->batchSize = 100;
+
+   this->checkpointing = false;
+
+   this->failureTime = 0.0;
+   this->lowerTime = 0.0;
+
+   // Memo may keep results of another test function;
+   if ( engine != NULL )
+      {
+      engine->clearMemo();
+      engine->resetSkippedTests();
+      }
+   this->checkpointTag = 0;
+   };
+
+
+ReliabilityEstimator::~ReliabilityEstimator()
+   {
+   // Restore signal handlers if estimate was not finished;
+   if ( checkpointing )
+      {
+      signal( SIGINT, previousIntHandler );
+      signal( SIGTERM, previousTermHandler );
+      }
+
+   if ( engine != NULL ) engine->release();
+   if ( testFunction != NULL ) testFunction->release();
+   };
+
+
+void ReliabilityEstimator::setPrecision( double precision, unsigned int batchSize )
+   {
+   this->precision = precision;
+   this->batchSize = ( batchSize > 0 ) ? batchSize : 1;
+   };
+
+
+void ReliabilityEstimator::setCheckpointTag( uint32_t tag )
+   {
+   this->checkpointTag = tag;
+   };
+
+
+Estimate ReliabilityEstimator::estimateTimeToFail( unsigned int times )
+   {
+   bool biased = engine->isBiased();
+   unsigned int budget = startReplicas( times );
+
+   bool bisectable = isBisectable();
+   double controlMean = getControlMean();
+   bool controlled = ( controlMean >= 0.0 );
+
+   // Inspected replicas give both bounds of failure time, controlled
+   // ones give control variate before it;
+   unsigned int stride = ( engine->isInspected() || controlled ) ? 2 : 1;
+   std::vector< double > values;
+   openCheckpoint( TIME_TO_FAIL, 0.0, budget, stride, values );
+
+   std::vector< double > lowers;
+   std::vector< double > uppers;
+   std::vector< double > controls;
+   for ( unsigned int i = 0; i < values.size(); i += stride )
+      {
+      if ( controlled ) controls.push_back( values[ i ] ); else lowers.push_back( values[ i ] );
+      uppers.push_back( values[ i + stride - 1 ] );
+      }
+
+   while ( needReplicas( uppers, budget, false, false ) )
+      {
+      double control = ( controlled ) ? getControl() : 0.0;
+      double lower = 0.0;
+      double upper = 0.0;
+      if ( ( bisectable ) ? bisectToFailure() : runToFailure() )
+         {
+         double ratio = ( biased ) ? engine->getLikelihoodRatio( failureTime ) : 1.0;
+         lower = lowerTime * ratio;
+         upper = failureTime * ratio;
+         }
+
+      if ( controlled )
+         {
+         controls.push_back( control );
+         values.push_back( control );
+         }
+      else
+         {
+         lowers.push_back( lower );
+         if ( stride == 2 ) values.push_back( lower );
+         }
+
+      uppers.push_back( upper );
+      values.push_back( upper );
+      engine->restart();
+      updateCheckpoint( values );
+      }
+
+   closeCheckpoint();
+
+   if ( controlled ) return estimateMean( uppers, controls, controlMean );
+
+   Estimate estimate = estimateMean( uppers, false );
+   if ( stride == 1 ) return estimate;
+
+   Estimate lower = estimateMean( lowers, false );
+   estimate.value = 0.5 * ( lower.value + estimate.value );
+   estimate.lower = lower.lower;
+   return estimate;
+   };
+
+
+Estimate ReliabilityEstimator::estimateSurvivalFunction( double time, unsigned int times )
+   {
+   bool biased = engine->isBiased();
+   unsigned int budget = startReplicas( times );
+   double controlMean = getControlMean();
+   bool controlled = ( controlMean >= 0.0 );
+
+   // Controlled replicas give control variate before survival;
+   unsigned int stride = ( controlled ) ? 2 : 1;
+   std::vector< double > values;
+   openCheckpoint( SURVIVAL_FUNCTION, time, budget, stride, values );
+
+   std::vector< double > survivals;
+   std::vector< double > controls;
+   for ( unsigned int i = 0; i < values.size(); i += stride )
+      {
+      if ( controlled ) controls.push_back( values[ i ] );
+      survivals.push_back( values[ i + stride - 1 ] );
+      }
+
+   while ( needReplicas( survivals, budget, ! biased, true ) )
+      {
+      if ( controlled )
+         {
+         controls.push_back( getControl() );
+         values.push_back( controls.back() );
+         }
+
+      double x = 0.0;
+      if ( ! biased )
+         {
+         engine->stepUntil( time );
+         if ( testEngine() ) x = 1.0;
+         }
+      else if ( runToFailure( time ) )
+         {
+         // Failures are frequent in biased replicas, so estimate their
+         // probability and take complement. Replica is weighted at the
+         // failure, so later faults do not shrink its weight;
+         x = engine->getLikelihoodRatio( failureTime );
+         }
+
+      survivals.push_back( x );
+      values.push_back( x );
+      engine->restart();
+      updateCheckpoint( values );
+      }
+
+   closeCheckpoint();
+
+   if ( controlled ) return estimateMean( survivals, controls, controlMean );
+   if ( ! biased ) return estimateMean( survivals, true );
+
+   Estimate failure = estimateMean( survivals, false );
+   Estimate estimate = {
+      1.0 - failure.value,
+      1.0 - failure.upper,
+      1.0 - failure.lower,
+      failure.times
+      };
+
+   return estimate;
+   };
+
+
+Estimate ReliabilityEstimator::estimateComponentImportance(
+   double time,
+   unsigned int times,
+   InterruptManager * manager,
+   unsigned int intSource
+   )
+   {
+   bool biased = engine->isBiased();
+   unsigned int budget = startReplicas( times );
+   std::vector< double > values;
+   openCheckpoint( COMPONENT_IMPORTANCE, time, budget, 1, values );
+   while ( needReplicas( values, budget, ! biased, true ) )
+      {
+      double x = 0.0;
+      engine->stepUntil( time );
+      if ( testEngine() )
+         {
+         // Simulated fault is not tracked by engine, so it is not memoized;
+         manager->simulateInterrupt( intSource );
+         if ( ! testFunction->callPredicate() )
+            {
+            x = ( biased ) ? engine->getLikelihoodRatio( time ) : 1.0;
+            }
+         }
+
+      values.push_back( x );
+      engine->restart();
+      updateCheckpoint( values );
+      }
+
+   closeCheckpoint();
+
+   return estimateMean( values, ! biased );
+   };
+
+
+void ReliabilityEstimator::estimateTimeToFailDistribution(
+   unsigned int times,
+   std::vector< double > & distribution,
+   std::vector< double > & weights,
+   std::vector< double > & lowerBounds
+   )
+   {
+   bool biased = engine->isBiased();
+   engine->startRandomization();
+
+   // Every replica gives time and its weight, inspected replicas give
+   // lower bound of time as well;
+   unsigned int stride = ( engine->isInspected() ) ? 3 : 2;
+   std::vector< double > values;
+   openCheckpoint( TIME_TO_FAIL_DISTRIBUTION, 0.0, times, stride, values );
+   bool bisectable = isBisectable();
+   while ( values.size() < stride * times )
+      {
+      if ( bisectable ) bisectToFailure(); else runToFailure();
+      values.push_back( failureTime );
+      values.push_back( ( biased ) ? engine->getLikelihoodRatio( failureTime ) : 1.0 );
+      if ( stride == 3 ) values.push_back( lowerTime );
+      engine->restart();
+      updateCheckpoint( values );
+      }
+
+   closeCheckpoint();
+
+   distribution.resize( times );
+   weights.resize( times );
+   lowerBounds.resize( times );
+   for ( unsigned int i = 0; i < times; i ++ )
+      {
+      distribution[ i ] = values[ stride * i ];
+      weights[ i ] = values[ stride * i + 1 ];
+      lowerBounds[ i ] = ( stride == 3 ) ? values[ 3 * i + 2 ] : distribution[ i ];
+      }
+   };
+
+
+void ReliabilityEstimator::estimateFaultsCountDistribution(
+   unsigned int times,
+   std::vector< InterruptManager * > & managers,
+   std::vector< double > & distribution
+   )
+   {
+   unsigned int componentsCount = 0;
+   for ( unsigned int i = 0; i < managers.size(); i ++ )
+      {
+      componentsCount += managers[ i ]->getIntSourcesCount();
+      }
+
+   bool biased = engine->isBiased();
+   engine->startRandomization();
+
+   // Every replica gives faults count and its weight;
+   std::vector< double > values;
+   openCheckpoint( FAULTS_COUNT_DISTRIBUTION, componentsCount, times, 2, values );
+   while ( values.size() < 2 * times )
+      {
+      runToFailure();
+
+      unsigned int faultsCount = 0;
+      for ( unsigned int j = 0; j < managers.size(); j ++ )
+         {
+         faultsCount += managers[ j ]->getInterruptsCount();
+         }
+
+      values.push_back( faultsCount );
+      values.push_back( ( biased ) ? engine->getLikelihoodRatio( failureTime ) : 1.0 );
+      engine->restart();
+      updateCheckpoint( values );
+      }
+
+   closeCheckpoint();
+
+   distribution.assign( componentsCount + 1, 0.0 );
+   for ( unsigned int i = 0; i < times; i ++ )
+      {
+      distribution[ ( unsigned int ) values[ 2 * i ] ] += values[ 2 * i + 1 ];
+      }
+
+   for ( unsigned int i = 0; i <= componentsCount; i ++ ) distribution[ i ] /= times;
+   };
+
+
+void ReliabilityEstimator::sampleFailureOrders(
+   unsigned int times,
+   std::vector< InterruptManager * > & managers,
+   std::vector< double > & counts
+   )
+   {
+   std::vector< std::pair< InterruptManager *, unsigned int > > sources;
+   collectSources( managers, sources );
+
+   unsigned int n = sources.size();
+   counts.assign( n + 2, 0.0 );
+
+   std::vector< unsigned int > order( n );
+   for ( unsigned int i = 0; i < n; i ++ ) order[ i ] = i;
+
+   bool bisected = engine->isBisected();
+   bool failed = ! testFunction->callPredicate();
+
+   // Every replica draws its order from its own stream;
+   uint32_t replica = engine->getReplica();
+   RandomGenerator generator;
+   std::vector< unsigned int > marks;
+   for ( unsigned int r = 0; r < times; r ++ )
+      {
+      generator.setStream( engine->getSeed(), replica + r, 0xfffffffdU );
+      unsigned int drawnCount = 0;
+
+      // Test passes with lower and fails with upper count of faults;
+      unsigned int lower = 0;
+      unsigned int upper = n + 1;
+      if ( failed ) upper = 0;
+
+      while ( upper > lower + 1 )
+         {
+         unsigned int count = lower + 1;
+         if ( bisected )
+            {
+            // Jumps grow until test fails, then they are bisected;
+            count = ( upper <= n ) ? ( lower + upper ) / 2 : 2 * lower;
+            if ( count <= lower ) count = lower + 1;
+            if ( count > n ) count = n;
+            }
+
+         applyFaults( sources, order, marks, drawnCount, count, generator );
+         if ( testFunction->callPredicate() ) lower = count; else upper = count;
+         }
+
+      counts[ upper ] += 1.0;
+      applyFaults( sources, order, marks, drawnCount, 0, generator );
+      }
+
+   engine->setReplica( replica + times );
+   };
+
+
+void ReliabilityEstimator::applyFaults(
+   const std::vector< std::pair< InterruptManager *, unsigned int > > & sources,
+   std::vector< unsigned int > & order,
+   std::vector< unsigned int > & marks,
+   unsigned int & drawnCount,
+   unsigned int count,
+   RandomGenerator & generator
+   )
+   {
+   // Faults are undone in reverse order to marks taken before them;
+   while ( marks.size() > count )
+      {
+      sources[ order[ marks.size() - 1 ] ].first->undoToMark( marks.back() );
+      marks.pop_back();
+      }
+
+   while ( marks.size() < count )
+      {
+      unsigned int i = marks.size();
+      if ( i == drawnCount )
+         {
+         // Partial Fisher-Yates shuffle of any order gives uniform one;
+         unsigned int j = i + ( unsigned int ) ( generator.generateUniform() * ( order.size() - i ) );
+         if ( j >= order.size() ) j = order.size() - 1;
+
+         unsigned int swap = order[ i ];
+         order[ i ] = order[ j ];
+         order[ j ] = swap;
+         drawnCount ++;
+         }
+
+      InterruptManager * manager = sources[ order[ i ] ].first;
+      marks.push_back( manager->getUndoMark() );
+      manager->simulateInterrupt( sources[ order[ i ] ].second );
+      }
+   };
+
+
+Estimate ReliabilityEstimator::estimateFailureSplitting(
+   double time,
+   unsigned int times,
+   const std::vector< double > & levels,
+   CustomFunction * scoreFunction,
+   unsigned int runs
+   )
+   {
+   if ( times == 0 || runs == 0 )
+      {
+      Estimate estimate = { 0.0, 0.0, 0.0, 0 };
+      return estimate;
+      }
+
+   if ( ! isSplittable() ) return estimateFailureBySurvival( time, times * runs );
+
+   // States are replayed from their replicas, which is cheaper without
+   // worker threads sampling replicas ahead;
+   unsigned int threadsCount = engine->getThreadsCount();
+   engine->setThreadsCount( 0 );
+
+   // Replicas and branches are numbered in the order they are started;
+   uint32_t replica = engine->getReplica();
+   RandomGenerator generator( engine->getSeed(), replica, 0xffffffffU );
+
+   std::vector< double > values;
+   bool replayed = true;
+   try
+      {
+      for ( unsigned int run = 0; run < runs && replayed; run ++ )
+         {
+         std::vector< SplittingState > states;
+         std::vector< SplittingState > reached;
+         double p = 1.0;
+         for ( unsigned int stage = 0; stage <= levels.size() && p > 0.0 && replayed; stage ++ )
+            {
+            // The last stage runs to failure;
+            double level = ( stage < levels.size() ) ? levels[ stage ] : HUGE_VAL;
+
+            // States are cloned evenly from random offset, so every state
+            // is expected to get the same number of clones;
+            unsigned int offset = 0;
+            if ( stage > 0 )
+               {
+               offset = ( unsigned int ) ( generator.generateUniform() * states.size() );
+               if ( offset >= states.size() ) offset = states.size() - 1;
+               }
+
+            reached.clear();
+            for ( unsigned int i = 0; i < times; i ++ )
+               {
+               SplittingState state;
+               if ( stage == 0 )
+                  {
+                  engine->setReplica( replica );
+                  state.path.push_back( std::make_pair( replica ++, 0U ) );
+                  state.failed = ! testEngine();
+                  state.sourcesHash = 0;
+                  }
+               else
+                  {
+                  state = states[ ( offset + i ) % states.size() ];
+                  if ( ! state.failed )
+                     {
+                     // Clone of state, which is not reproduced, would not
+                     // start from the level;
+                     if ( ! replayState( state ) )
+                        {
+                        replayed = false;
+                        break;
+                        }
+
+                     engine->branchReplica( replica );
+                     state.path.push_back( std::make_pair( replica ++, 0U ) );
+                     }
+                  }
+
+               if ( state.failed ||
+                  getScore( scoreFunction ) >= level ||
+                  runToLevel( time, level, scoreFunction, state )
+                  ) reached.push_back( state );
+               }
+
+            p *= ( double ) reached.size() / times;
+            states.swap( reached );
+            }
+
+         values.push_back( p );
+         }
+      }
+   catch ( CustomFunctionExcp & )
+      {
+      // Restore threads for the next estimate;
+      engine->setThreadsCount( threadsCount );
+      throw;
+      }
+
+   engine->setReplica( replica );
+   engine->setThreadsCount( threadsCount );
+
+   // Estimate is not biased by clones started below the level;
+   if ( ! replayed ) return estimateFailureBySurvival( time, times * runs );
+
+   // Runs are few, so interval is Student one;
+   double m = 0.0;
+   double msqr = 0.0;
+   for ( unsigned int i = 0; i < runs; i ++ )
+      {
+      m += values[ i ];
+      msqr += values[ i ] * values[ i ];
+      }
+
+   m /= runs;
+   msqr /= runs;
+   double delta = ( runs > 1 ) ? calcStudentMeanDelta( m, msqr, runs, 0.95 ) : 0.0;
+
+   Estimate estimate = { m, m - delta, m + delta, runs };
+   if ( estimate.lower < 0.0 ) estimate.lower = 0.0;
+   return estimate;
+   };
+
+
+void ReliabilityEstimator::countSurvivingSets(
+   unsigned int maxFaults,
+   std::vector< InterruptManager * > & managers,
+   std::vector< double > & counts
+   )
+   {
+   std::vector< std::pair< InterruptManager *, unsigned int > > sources;
+   collectSources( managers, sources );
+
+   if ( maxFaults > sources.size() ) maxFaults = sources.size();
+   counts.assign( maxFaults + 1, 0.0 );
+
+   // Engine memo is keyed by interrupts handled, not simulated;
+   if ( testFunction->callPredicate() ) counts[ 0 ] = 1.0;
+   if ( maxFaults > 0 ) countSurvivingSets( sources, 0, 0, counts );
+   };
+
+
+void ReliabilityEstimator::findMinimalCutSets(
+   unsigned int maxFaults,
+   std::vector< InterruptManager * > & managers,
+   std::vector< std::vector< unsigned int > > & cutSets
+   )
+   {
+   std::vector< std::pair< InterruptManager *, unsigned int > > sources;
+   collectSources( managers, sources );
+
+   cutSets.clear();
+
+   // Network failed without faults has the only empty cut set;
+   if ( ! testFunction->callPredicate() )
+      {
+      cutSets.push_back( std::vector< unsigned int >() );
+      return;
+      }
+
+   if ( maxFaults > sources.size() ) maxFaults = sources.size();
+
+   std::vector< unsigned int > set;
+   std::vector< bool > failed( sources.size(), false );
+   std::vector< std::vector< unsigned int > > lastCutSets( sources.size() );
+   for ( unsigned int size = 1; size <= maxFaults; size ++ )
+      {
+      unsigned int first = cutSets.size();
+      findCutSets( sources, 0, size, set, failed, lastCutSets, cutSets );
+
+      for ( unsigned int j = first; j < cutSets.size(); j ++ )
+         {
+         lastCutSets[ cutSets[ j ].back() ].push_back( j );
+         }
+      }
+   };
+
+
+ReliabilityEstimator::ReliabilityEstimator()
+   {
+   // Do nothing;
+   };
+
+
+ReliabilityEstimator::ReliabilityEstimator( const ReliabilityEstimator & other )
+   {
+   // Do nothing;
+   };
+
+
+ReliabilityEstimator & ReliabilityEstimator::operator =( const ReliabilityEstimator & other )
+   {
+   // Do nothing;
+   return * this;
+   };
+
+
+bool ReliabilityEstimator::testEngine()
+   {
+   bool result;
+   if ( engine->findMemo( result ) ) return result;
+
+   result = testFunction->callPredicate();
+   engine->storeMemo( result );
+
+   return result;
+   };
+
+
+bool ReliabilityEstimator::runToFailure()
+   {
+   if ( engine->isInspected() ) return inspectToFailure( -1.0 );
+
+   bool failed = ! testEngine();
+   while ( ! failed && engine->stepOver() )
+      {
+      failed = ! isStepMasked() && ! testEngine();
+      }
+
+   // Failure is detected at the interrupt causing it;
+   failureTime = engine->getCurrentTime();
+   lowerTime = failureTime;
+   return failed;
+   };
+
+
+bool ReliabilityEstimator::runToFailure( double time )
+   {
+   if ( engine->isInspected() ) return inspectToFailure( time );
+
+   bool failed = ! testEngine();
+   while ( ! failed )
+      {
+      double futureTime = engine->getFutureTime();
+      if ( futureTime < 0.0 || futureTime > time ) break;
+
+      engine->stepOver();
+      failed = ! isStepMasked() && ! testEngine();
+      }
+
+   failureTime = engine->getCurrentTime();
+   lowerTime = failureTime;
+   return failed;
+   };
+
+
+bool ReliabilityEstimator::inspectToFailure( double time )
+   {
+   double period = engine->getInspectionPeriod();
+   unsigned int faultsPeriod = engine->getInspectionFaults();
+   bool bounded = ( time >= 0.0 );
+
+   // The first inspection takes place at time 0;
+   lowerTime = 0.0;
+   failureTime = 0.0;
+   if ( ! testEngine() ) return true;
+
+   // Inspections of components unchanged since the last test pass
+   // without calling it;
+   bool changed = false;
+   double next = 0.0;
+   unsigned int faultsCount = 0;
+   while ( true )
+      {
+      double futureTime = engine->getFutureTime();
+      bool finished = ( futureTime < 0.0 || ( bounded && futureTime > time ) );
+
+      // Periodic inspection comes before the next interrupt, interrupts
+      // at the time of inspection are handled first;
+      if ( changed && period > 0.0 && ( ! bounded || next <= time ) &&
+         ( finished || futureTime > next )
+         )
+         {
+         failureTime = next;
+         if ( ! testEngine() ) return true;
+
+         lowerTime = next;
+         changed = false;
+         }
+
+      if ( finished ) break;
+
+      engine->stepOver();
+      faultsCount ++;
+      double currentTime = engine->getCurrentTime();
+
+      if ( ! changed && engine->getCurrentIntSource()->isStateChanged() )
+         {
+         changed = true;
+
+         // Periodic inspections before interrupt passed, since they saw
+         // components of the last test;
+         if ( period > 0.0 )
+            {
+            double k = ceil( currentTime / period );
+            next = ( ( k < 1.0 ) ? 1.0 : k ) * period;
+            if ( next - period > lowerTime ) lowerTime = next - period;
+            }
+         }
+
+      if ( faultsPeriod > 0 && faultsCount % faultsPeriod == 0 )
+         {
+         if ( changed )
+            {
+            failureTime = currentTime;
+            if ( ! testEngine() ) return true;
+
+            changed = false;
+            }
+
+         lowerTime = currentTime;
+         }
+      }
+
+   // Replica ends with inspection at the time given or after the last
+   // interrupt;
+   if ( changed )
+      {
+      failureTime = ( bounded ) ? time : engine->getCurrentTime();
+      if ( ! testEngine() ) return true;
+      }
+
+   failureTime = engine->getCurrentTime();
+   lowerTime = failureTime;
+   return false;
+   };
+
+
+bool ReliabilityEstimator::bisectToFailure()
+   {
+   lowerTime = 0.0;
+   failureTime = 0.0;
+   if ( ! testEngine() ) return true;
+
+   // Interrupts of the last jump and undo marks of their managers before
+   // each of them;
+   std::vector< InterruptManager * > managers;
+   std::vector< unsigned int > sources;
+   std::vector< unsigned int > marks;
+   std::vector< double > times;
+
+   unsigned int jump = 1;
+   while ( true )
+      {
+      managers.clear();
+      sources.clear();
+      marks.clear();
+      times.clear();
+
+      while ( managers.size() < jump && engine->getFutureTime() >= 0.0 )
+         {
+         InterruptManager * manager = engine->getFutureIntSource();
+         marks.push_back( manager->getUndoMark() );
+         engine->stepOver();
+         managers.push_back( manager );
+         sources.push_back( manager->getLastIntSource() );
+         times.push_back( engine->getCurrentTime() );
+         }
+
+      if ( managers.empty() ) break;
+
+      if ( ! testEngine() )
+         {
+         // Faults only accumulate, so interrupts before the first failing
+         // one pass test and the rest fail it;
+         unsigned int lower = 0;
+         unsigned int upper = managers.size();
+         unsigned int applied = upper;
+         while ( upper - lower > 1 )
+            {
+            unsigned int middle = ( lower + upper ) / 2;
+            while ( applied > middle )
+               {
+               applied --;
+               managers[ applied ]->undoToMark( marks[ applied ] );
+               }
+
+            while ( applied < middle )
+               {
+               managers[ applied ]->simulateInterrupt( sources[ applied ] );
+               applied ++;
+               }
+
+            // Engine memo is keyed by interrupts handled, not simulated;
+            if ( testFunction->callPredicate() ) lower = middle; else upper = middle;
+            }
+
+         // Components are left as they are, reinit restores all of them;
+         failureTime = times[ upper - 1 ];
+         lowerTime = failureTime;
+         return true;
+         }
+
+      if ( managers.size() < jump ) break;
+      jump *= 2;
+      }
+
+   failureTime = engine->getCurrentTime();
+   lowerTime = failureTime;
+   return false;
+   };
+
+
+bool ReliabilityEstimator::isBisectable()
+   {
+   if ( ! engine->isBisected() || engine->isInspected() || engine->isBiased() ) return false;
+
+   for ( unsigned int i = 0; i < engine->getManagersCount(); i ++ )
+      {
+      InterruptManager * manager = engine->getManager( i );
+      if ( manager != NULL && manager->isUnlimitedRegeneration() ) return false;
+      }
+
+   return true;
+   };
+
+
+bool ReliabilityEstimator::replayState( const SplittingState & state )
+   {
+   uint64_t sourcesHash = 0;
+   for ( unsigned int i = 0; i < state.path.size(); i ++ )
+      {
+      if ( i == 0 )
+         {
+         engine->setReplica( state.path[ i ].first );
+         }
+      else
+         {
+         engine->branchReplica( state.path[ i ].first );
+         }
+
+      for ( unsigned int j = 0; j < state.path[ i ].second; j ++ ) stepState( sourcesHash );
+      }
+
+   return sourcesHash == state.sourcesHash;
+   };
+
+
+void ReliabilityEstimator::stepState( uint64_t & sourcesHash )
+   {
+   engine->stepOver();
+
+   InterruptManager * manager = engine->getCurrentIntSource();
+   if ( manager == NULL ) return;
+
+   uint64_t key = ( ( uint64_t ) ( size_t ) manager << 32 ) ^ ( uint32_t ) manager->getLastIntSource();
+   key = ( key ^ ( key >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+   key = ( key ^ ( key >> 27 ) ) * 0x94d049bb133111ebULL;
+   sourcesHash = sourcesHash * 0x100000001b3ULL + ( key ^ ( key >> 31 ) );
+   };
+
+
+bool ReliabilityEstimator::runToLevel(
+   double time,
+   double level,
+   CustomFunction * scoreFunction,
+   SplittingState & state
+   )
+   {
+   while ( true )
+      {
+      double futureTime = engine->getFutureTime();
+      if ( futureTime < 0.0 || futureTime > time ) return false;
+
+      stepState( state.sourcesHash );
+      state.path.back().second ++;
+
+      // Unchanged components keep both test result and score;
+      if ( isStepMasked() ) continue;
+
+      state.failed = ! testEngine();
+      if ( state.failed || getScore( scoreFunction ) >= level ) return true;
+      }
+   };
+
+
+Estimate ReliabilityEstimator::estimateFailureBySurvival( double time, unsigned int times )
+   {
+   Estimate survival = estimateSurvivalFunction( time, times );
+   Estimate estimate = {
+      1.0 - survival.value,
+      1.0 - survival.upper,
+      1.0 - survival.lower,
+      survival.times
+      };
+
+   return estimate;
+   };
+
+
+double ReliabilityEstimator::getScore( CustomFunction * scoreFunction )
+   {
+   if ( scoreFunction != NULL ) return scoreFunction->callScore( engine->getCurrentTime() );
+
+   unsigned int interruptsCount = 0;
+   for ( unsigned int i = 0; i < engine->getManagersCount(); i ++ )
+      {
+      InterruptManager * manager = engine->getManager( i );
+      if ( manager != NULL ) interruptsCount += manager->getInterruptsCount();
+      }
+
+   return interruptsCount;
+   };
+
+
+bool ReliabilityEstimator::isSplittable()
+   {
+   if ( engine->isInspected() || engine->isBiased() ) return false;
+
+   for ( unsigned int i = 0; i < engine->getManagersCount(); i ++ )
+      {
+      InterruptManager * manager = engine->getManager( i );
+      if ( manager != NULL && manager->isUnlimitedRegeneration() ) return false;
+      }
+
+   return true;
+   };
+
+
+void ReliabilityEstimator::countSurvivingSets(
+   const std::vector< std::pair< InterruptManager *, unsigned int > > & sources,
+   unsigned int first,
+   unsigned int faultsCount,
+   std::vector< double > & counts
+   )
+   {
+   for ( unsigned int i = first; i < sources.size(); i ++ )
+      {
+      InterruptManager * manager = sources[ i ].first;
+      unsigned int mark = manager->getUndoMark();
+      manager->simulateInterrupt( sources[ i ].second );
+
+      if ( testFunction->callPredicate() ) counts[ faultsCount + 1 ] += 1.0;
+      if ( faultsCount + 2 < counts.size() ) countSurvivingSets( sources, i + 1, faultsCount + 1, counts );
+
+      manager->undoToMark( mark );
+      }
+   };
+
+
+void ReliabilityEstimator::findCutSets(
+   const std::vector< std::pair< InterruptManager *, unsigned int > > & sources,
+   unsigned int first,
+   unsigned int size,
+   std::vector< unsigned int > & set,
+   std::vector< bool > & failed,
+   const std::vector< std::vector< unsigned int > > & lastCutSets,
+   std::vector< std::vector< unsigned int > > & cutSets
+   )
+   {
+   unsigned int last = sources.size() + set.size() - size;
+   for ( unsigned int i = first; i <= last; i ++ )
+      {
+      set.push_back( i );
+      failed[ i ] = true;
+
+      // Set containing a cut set is not minimal, nor its supersets;
+      bool contains = false;
+      for ( unsigned int j = 0; j < lastCutSets[ i ].size() && ! contains; j ++ )
+         {
+         const std::vector< unsigned int > & cutSet = cutSets[ lastCutSets[ i ][ j ] ];
+
+         contains = true;
+         for ( unsigned int k = 0; k < cutSet.size() && contains; k ++ ) contains = failed[ cutSet[ k ] ];
+         }
+
+      if ( ! contains )
+         {
+         InterruptManager * manager = sources[ i ].first;
+         unsigned int mark = manager->getUndoMark();
+         manager->simulateInterrupt( sources[ i ].second );
+
+         if ( set.size() < size )
+            {
+            findCutSets( sources, i + 1, size, set, failed, lastCutSets, cutSets );
+            }
+         else if ( ! testFunction->callPredicate() )
+            {
+            cutSets.push_back( set );
+            }
+
+         manager->undoToMark( mark );
+         }
+
+      failed[ i ] = false;
+      set.pop_back();
+      }
+   };
+
+
+void ReliabilityEstimator::collectSources(
+   std::vector< InterruptManager * > & managers,
+   std::vector< std::pair< InterruptManager *, unsigned int > > & sources
+   )
+   {
+   for ( unsigned int i = 0; i < managers.size(); i ++ )
+      {
+      for ( unsigned int j = 0; j < managers[ i ]->getIntSourcesCount(); j ++ )
+         {
+         sources.push_back( std::make_pair( managers[ i ], j ) );
+         }
+      }
+   };
+
+
+bool ReliabilityEstimator::isStepMasked()
+   {
+   // Test passed before interrupt, so it passes after it as well;
+   if ( engine->getCurrentIntSource()->isStateChanged() ) return false;
+
+   engine->countSkippedTest();
+   return true;
+   };
+
+
+unsigned int ReliabilityEstimator::startReplicas( unsigned int times )
+   {
+   unsigned int pointsCount = engine->getPointsCount();
+   if ( pointsCount == 1 ) return times;
+
+   engine->startRandomization();
+
+   unsigned int randomizationsCount = ( times + pointsCount / 2 ) / pointsCount;
+   if ( randomizationsCount < 2 ) randomizationsCount = 2;
+
+   return randomizationsCount * pointsCount;
+   };
+
+
+Estimate ReliabilityEstimator::estimateMean( const std::vector< double > & values, bool binomial )
+   {
+   unsigned int times = values.size();
+   unsigned int pointsCount = engine->getPointsCount();
+   Estimate estimate = { 0.0, 0.0, 0.0, times };
+
+   if ( pointsCount > 1 )
+      {
+      // Replicas of one randomization are dependent, but randomizations
+      // are not, so their means give unbiased variance estimate;
+      unsigned int randomizationsCount = times / pointsCount;
+      double m = 0.0;
+      double msqr = 0.0;
+      for ( unsigned int i = 0; i < randomizationsCount; i ++ )
+         {
+         double x = 0.0;
+         for ( unsigned int j = 0; j < pointsCount; j ++ ) x += values[ i * pointsCount + j ];
+
+         x /= pointsCount;
+         m += x;
+         msqr += x * x;
+         }
+
+      m /= randomizationsCount;
+      msqr /= randomizationsCount;
+      double delta = calcStudentMeanDelta( m, msqr, randomizationsCount, 0.95 );
+
+      estimate.value = m;
+      estimate.lower = m - delta;
+      estimate.upper = m + delta;
+      return estimate;
+      }
+
+   double sum = 0.0;
+   double sumsqr = 0.0;
+   for ( unsigned int i = 0; i < times; i ++ )
+      {
+      sum += values[ i ];
+      sumsqr += values[ i ] * values[ i ];
+      }
+
+   double p = sum / times;
+   estimate.value = p;
+
+   if ( binomial )
+      {
+      calcACProbabilityBounds( p, times, 0.05, estimate.lower, estimate.upper );
+      }
+   else
+      {
+      // Weighted or continuous values are not binomial, so use normal
+      // interval;
+      double delta = calcMeanDelta( p, sumsqr / times, times, 0.95 );
+      estimate.lower = p - delta;
+      estimate.upper = p + delta;
+      }
+
+   return estimate;
+   };
+
+
+Estimate ReliabilityEstimator::estimateMean(
+   const std::vector< double > & values,
+   const std::vector< double > & controls,
+   double controlMean
+   )
+   {
+   unsigned int pointsCount = engine->getPointsCount();
+   unsigned int count = values.size() / pointsCount;
+   if ( count < 3 ) return estimateMean( values, false );
+
+   std::vector< double > y( count, 0.0 );
+   std::vector< double > c( count, 0.0 );
+   for ( unsigned int i = 0; i < count * pointsCount; i ++ )
+      {
+      y[ i / pointsCount ] += values[ i ] / pointsCount;
+      c[ i / pointsCount ] += controls[ i ] / pointsCount;
+      }
+
+   double delta = 0.0;
+   double mean = calcControlledMean( y, c, controlMean, 0.95, delta );
+
+   Estimate estimate = { mean, mean - delta, mean + delta, ( unsigned int ) values.size() };
+   return estimate;
+   };
+
+
+double ReliabilityEstimator::getControlMean()
+   {
+   InterruptManager * manager = engine->getControlManager();
+   unsigned int faultsCount = engine->getControlFaults();
+   if ( manager == NULL ||
+      faultsCount == 0 ||
+      engine->isInspected() ||
+      engine->isBiased() ||
+      manager->isLazySampling() ||
+      manager->isUnlimitedRegeneration() ||
+      manager->getDistribution() == NULL
+      ) return -1.0;
+
+   // Manager has to be sampled by the engine;
+   for ( unsigned int i = 0; i < engine->getManagersCount(); i ++ )
+      {
+      if ( engine->getManager( i ) == manager )
+         {
+         return manager->getDistribution()->orderedMean( faultsCount, manager->getIntSourcesCount() );
+         }
+      }
+
+   return -1.0;
+   };
+
+
+double ReliabilityEstimator::getControl()
+   {
+   return engine->getControlManager()->getOrderedInterrupt( engine->getControlFaults() );
+   };
+
+
+bool ReliabilityEstimator::needReplicas(
+   const std::vector< double > & values,
+   unsigned int budget,
+   bool binomial,
+   bool probability
+   )
+   {
+   unsigned int times = values.size();
+   if ( times >= budget ) return false;
+   if ( precision <= 0.0 ) return true;
+
+   // Randomizations of sampling plan can not be split, and at least two
+   // of them are needed for interval;
+   unsigned int pointsCount = engine->getPointsCount();
+   unsigned int batch = ( ( batchSize + pointsCount - 1 ) / pointsCount ) * pointsCount;
+   if ( times == 0 || times % batch != 0 ) return true;
+   if ( pointsCount > 1 && times < 2 * pointsCount ) return true;
+
+   Estimate estimate = estimateMean( values, binomial );
+   double scale = fabs( estimate.value );
+   if ( probability && 1.0 - estimate.value < scale ) scale = 1.0 - estimate.value;
+
+   return 0.5 * ( estimate.upper - estimate.lower ) > precision * scale;
+   };
+
+
+void ReliabilityEstimator::openCheckpoint(
+   CHECKPOINT_KIND kind,
+   double parameter,
+   unsigned int budget,
+   unsigned int stride,
+   std::vector< double > & values
+   )
+   {
+   checkpointing = ! engine->getCheckpointFile().empty();
+   if ( ! checkpointing ) return;
+
+   checkpointKind = kind;
+   checkpointParameter = parameter;
+   checkpointBudget = budget;
+   checkpointStride = stride;
+   checkpointSeed = engine->getSeed();
+   checkpointFingerprint = getModelFingerprint();
+   firstReplica = engine->getReplica();
+   checkpointTime = time( NULL );
+
+   FILE * file = fopen( engine->getCheckpointFile().c_str(), "rb" );
+   if ( file != NULL )
+      {
+      // Header has to match the estimate started, otherwise checkpoint
+      // belongs to another one and is overwritten;
+      char signature[ 4 ];
+      uint32_t version = 0;
+      uint32_t header[ 5 ];
+      double savedParameter = 0.0;
+      uint64_t savedSeed = 0;
+      uint64_t savedFingerprint = 0;
+      uint32_t savedReplica = 0;
+      uint32_t count = 0;
+
+      bool matches =
+         fread( signature, sizeof( signature ), 1, file ) == 1 &&
+         fread( & version, sizeof( version ), 1, file ) == 1 &&
+         fread( header, sizeof( header ), 1, file ) == 1 &&
+         fread( & savedParameter, sizeof( savedParameter ), 1, file ) == 1 &&
+         fread( & savedSeed, sizeof( savedSeed ), 1, file ) == 1 &&
+         fread( & savedFingerprint, sizeof( savedFingerprint ), 1, file ) == 1 &&
+         fread( & savedReplica, sizeof( savedReplica ), 1, file ) == 1 &&
+         fread( & count, sizeof( count ), 1, file ) == 1 &&
+         memcmp( signature, CHECKPOINT_SIGNATURE, sizeof( signature ) ) == 0 &&
+         version == CHECKPOINT_VERSION &&
+         header[ 0 ] == checkpointTag &&
+         header[ 1 ] == checkpointKind &&
+         header[ 2 ] == checkpointBudget &&
+         header[ 3 ] == checkpointStride &&
+         header[ 4 ] == engine->getPointsCount() &&
+         savedParameter == checkpointParameter &&
+         savedSeed == checkpointSeed &&
+         savedFingerprint == checkpointFingerprint &&
+         savedReplica == firstReplica &&
+         ( uint64_t ) count <= ( uint64_t ) budget * stride &&
+         count % stride == 0;
+
+      if ( matches )
+         {
+         values.resize( count );
+         if ( count > 0 && fread( & values[ 0 ], sizeof( double ), count, file ) != count ) values.clear();
+         }
+
+      fclose( file );
+
+      // Skip finished replicas;
+      if ( ! values.empty() ) engine->setReplica( firstReplica + values.size() / stride );
+      }
+
+   caughtSignal = 0;
+   previousIntHandler = signal( SIGINT, catchSignal );
+   previousTermHandler = signal( SIGTERM, catchSignal );
+   };
+
+
+void ReliabilityEstimator::updateCheckpoint( const std::vector< double > & values )
+   {
+   if ( ! checkpointing ) return;
+
+   if ( caughtSignal != 0 )
+      {
+      saveCheckpoint( values );
+
+      // Let the previous handler deal with signal;
+      int caught = caughtSignal;
+      checkpointing = false;
+      signal( SIGINT, previousIntHandler );
+      signal( SIGTERM, previousTermHandler );
+      raise( caught );
+      return;
+      }
+
+   if ( time( NULL ) - checkpointTime >= ( time_t ) engine->getCheckpointInterval() )
+      {
+      saveCheckpoint( values );
+      checkpointTime = time( NULL );
+      }
+   };
+
+
+void ReliabilityEstimator::closeCheckpoint()
+   {
+   if ( ! checkpointing ) return;
+
+   checkpointing = false;
+   signal( SIGINT, previousIntHandler );
+   signal( SIGTERM, previousTermHandler );
+
+   remove( engine->getCheckpointFile().c_str() );
+   };
+
+
+bool ReliabilityEstimator::saveCheckpoint( const std::vector< double > & values )
+   {
+   // Write temporary file and replace checkpoint, so it is never broken;
+   std::string fileName = engine->getCheckpointFile();
+   std::string tempFileName = fileName + ".tmp";
+
+   FILE * file = fopen( tempFileName.c_str(), "wb" );
+   if ( file == NULL ) return false;
+
+   uint32_t header[ 5 ] = {
+      checkpointTag,
+      checkpointKind,
+      checkpointBudget,
+      checkpointStride,
+      engine->getPointsCount()
+      };
+
+   uint32_t count = values.size();
+
+   bool written =
+      fwrite( CHECKPOINT_SIGNATURE, sizeof( CHECKPOINT_SIGNATURE ), 1, file ) == 1 &&
+      fwrite( & CHECKPOINT_VERSION, sizeof( CHECKPOINT_VERSION ), 1, file ) == 1 &&
+      fwrite( header, sizeof( header ), 1, file ) == 1 &&
+      fwrite( & checkpointParameter, sizeof( checkpointParameter ), 1, file ) == 1 &&
+      fwrite( & checkpointSeed, sizeof( checkpointSeed ), 1, file ) == 1 &&
+      fwrite( & checkpointFingerprint, sizeof( checkpointFingerprint ), 1, file ) == 1 &&
+      fwrite( & firstReplica, sizeof( firstReplica ), 1, file ) == 1 &&
+      fwrite( & count, sizeof( count ), 1, file ) == 1 &&
+      ( count == 0 || fwrite( & values[ 0 ], sizeof( double ), count, file ) == count );
+
+   written = ( fclose( file ) == 0 ) && written;
+   if ( ! written || rename( tempFileName.c_str(), fileName.c_str() ) != 0 )
+      {
+      remove( tempFileName.c_str() );
+      return false;
+      }
+
+   return true;
+   };
+
+
+uint64_t ReliabilityEstimator::getModelFingerprint()
+   {
+   // Distributions are told apart by their quantiles;
+   static const double quantiles[ 3 ] = { 0.1, 0.5, 0.9 };
+
+   std::vector< uint64_t > words;
+   for ( unsigned int i = 0; i < engine->getManagersCount(); i ++ )
+      {
+      InterruptManager * manager = engine->getManager( i );
+      if ( manager == NULL ) continue;
+
+      double bias = manager->getBias();
+      uint64_t bits = 0;
+      memcpy( & bits, & bias, sizeof( bits ) );
+
+      words.push_back( i );
+      words.push_back( manager->getIntSourcesCount() );
+      words.push_back( manager->isLazySampling() );
+      words.push_back( manager->isUnlimitedRegeneration() );
+      words.push_back( bits );
+
+      Distribution * distribution = manager->getDistribution();
+      for ( unsigned int j = 0; j < 3 && distribution != NULL; j ++ )
+         {
+         double quantile = distribution->inverseFunction( quantiles[ j ] );
+         memcpy( & bits, & quantile, sizeof( bits ) );
+         words.push_back( bits );
+         }
+      }
+
+   uint64_t fingerprint = 0xcbf29ce484222325ULL;
+   for ( unsigned int i = 0; i < words.size(); i ++ )
+      {
+      uint64_t key = words[ i ] + 0x9e3779b97f4a7c15ULL;
+      key = ( key ^ ( key >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+      key = ( key ^ ( key >> 27 ) ) * 0x94d049bb133111ebULL;
+      fingerprint = ( fingerprint ^ key ^ ( key >> 31 ) ) * 0x100000001b3ULL;
+      }
+
+   return fingerprint;
+   };
@@ -0,0 +1,345 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#ifndef RELIABILITYESTIMATOR_H
+#define RELIABILITYESTIMATOR_H
+
+
+#include <stdint.h>
+#include <time.h>
+#include <vector>
+
+
+#include "engine/SimulationEngine.h"
+#include "objects/CustomFunction.h"
+
+
+/***************************************************************************
+ *   Estimate struct declaration                                           *
+ ***************************************************************************/
+
+
+struct Estimate
+   {
+   double value;
+   double lower;
+   double upper;
+   unsigned int times;
+   };
+
+
+/***************************************************************************
+ *   ReliabilityEstimator class declaration                                *
+ ***************************************************************************/
+
+
+// Runs replicas of engine and evaluates test function after interrupts,
+// the network is considered failed as soon as test function returns false.
+// If engine is biased, every replica is weighted by its likelihood ratio
+// and confidence intervals are computed from weighted sample variance.
+// Biased survival is P( TTF > t ), which is the same as the unbiased
+// estimate for networks that do not recover from faults. If engine has
+// sampling plan, replicas are taken by whole randomizations, at least two
+// of them, and confidence intervals come from randomization means.
+// With precision set, times is only the budget: replicas are run by
+// batches until half-width of interval relative to the estimate falls
+// below precision. If engine has checkpoint file, every estimate keeps
+// values of finished replicas there and resumes from them, so resumed
+// estimate is the same as uninterrupted one. If engine is inspected, the
+// estimate of time to fail is between the estimates from bounds of
+// censoring intervals, and its confidence interval covers both of them;
+class ReliabilityEstimator
+   {
+   public:
+      ReliabilityEstimator( SimulationEngine * engine, CustomFunction * testFunction );
+      virtual ~ReliabilityEstimator();
+
+      // Precision 0 runs all the replicas. Batch is rounded up to whole
+      // randomizations of sampling plan;
+      void setPrecision( double precision, unsigned int batchSize );
+
+      // Tag tells checkpoints of estimates with the same arguments apart,
+      // e.g. points of parameter sweep;
+      void setCheckpointTag( uint32_t tag );
+
+      Estimate estimateTimeToFail( unsigned int times );
+      Estimate estimateSurvivalFunction( double time, unsigned int times );
+      Estimate estimateComponentImportance(
+         double time,
+         unsigned int times,
+         InterruptManager * manager,
+         unsigned int intSource
+         );
+
+      // Lower bounds are times of the last passed inspections, which are
+      // the same as failure times unless engine is inspected;
+      void estimateTimeToFailDistribution(
+         unsigned int times,
+         std::vector< double > & distribution,
+         std::vector< double > & weights,
+         std::vector< double > & lowerBounds
+         );
+
+      void estimateFaultsCountDistribution(
+         unsigned int times,
+         std::vector< InterruptManager * > & managers,
+         std::vector< double > & distribution
+         );
+
+      // Samples orders of faults instead of their times: sources of
+      // managers fail in uniformly random order, one per step, and every
+      // replica adds 1 to counts[ K ], where K = 0, ..., n is the count of
+      // faults at which test fails first, n + 1 if it never does. If all
+      // the n sources have i.i.d. lifetimes and do not regenerate, time
+      // to fail is K-th of n ordered lifetimes for any their distribution.
+      // Bisected engine searches K as bisectToFailure() does. Components
+      // have to be fault-free, e.g. right after restart;
+      void sampleFailureOrders(
+         unsigned int times,
+         std::vector< InterruptManager * > & managers,
+         std::vector< double > & counts
+         );
+
+      // Multilevel splitting estimate of probability that test fails by
+      // time, which is small enough to give no failures in plain replicas
+      // and needs no bias. Score of replica is the count of interrupts or
+      // the value of scoreFunction called with current time, failure
+      // reaches all the levels. Every stage runs times replicas from the
+      // states which reached previous level to the next one, cloning them
+      // evenly by branches of the engine. Interval comes from runs
+      // independent estimates. Engine that is biased, inspected or
+      // regenerates faults is estimated by plain replicas;
+      Estimate estimateFailureSplitting(
+         double time,
+         unsigned int times,
+         const std::vector< double > & levels,
+         CustomFunction * scoreFunction,
+         unsigned int runs
+         );
+
+      // Counts sets of k = 0, ..., maxFaults failed sources of managers
+      // that pass test, which give exact survival function of identical
+      // components for any distribution, see calcSurvivalPolynomial().
+      // Sets are visited depth-first from current components, applying
+      // or undoing one fault per step;
+      void countSurvivingSets(
+         unsigned int maxFaults,
+         std::vector< InterruptManager * > & managers,
+         std::vector< double > & counts
+         );
+
+      // Finds minimal sets of up to maxFaults failed sources of managers
+      // that fail test, for bounds of calcCutSetsBounds(). Sources are
+      // numbered through managers in their order. Sets are searched by
+      // size, so sets containing a smaller cut set are not tested, which
+      // requires test to be monotone, i.e. faults never repair network;
+      void findMinimalCutSets(
+         unsigned int maxFaults,
+         std::vector< InterruptManager * > & managers,
+         std::vector< std::vector< unsigned int > > & cutSets
+         );
+
+   private:
+      enum CHECKPOINT_KIND
+         {
+         TIME_TO_FAIL,
+         SURVIVAL_FUNCTION,
+         COMPONENT_IMPORTANCE,
+         TIME_TO_FAIL_DISTRIBUTION,
+         FAULTS_COUNT_DISTRIBUTION
+         };
+
+      ReliabilityEstimator();
+      ReliabilityEstimator( const ReliabilityEstimator & other );
+      ReliabilityEstimator & operator =( const ReliabilityEstimator & other );
+
+      // Calls test function unless its result for the current set of
+      // failed sources is found in engine memo;
+      bool testEngine();
+
+      // Counts surviving supersets of current set of faults, adding
+      // sources from first on;
+      void countSurvivingSets(
+         const std::vector< std::pair< InterruptManager *, unsigned int > > & sources,
+         unsigned int first,
+         unsigned int faultsCount,
+         std::vector< double > & counts
+         );
+
+      // Finds cut sets of size faults extending current set, adding
+      // sources from first on. Cut sets are indexed by their last source
+      // to check if failed sources contain one;
+      void findCutSets(
+         const std::vector< std::pair< InterruptManager *, unsigned int > > & sources,
+         unsigned int first,
+         unsigned int size,
+         std::vector< unsigned int > & set,
+         std::vector< bool > & failed,
+         const std::vector< std::vector< unsigned int > > & lastCutSets,
+         std::vector< std::vector< unsigned int > > & cutSets
+         );
+
+      // Applies or undoes faults of order until count of them is applied,
+      // sources of order are drawn from the rest as they are applied;
+      void applyFaults(
+         const std::vector< std::pair< InterruptManager *, unsigned int > > & sources,
+         std::vector< unsigned int > & order,
+         std::vector< unsigned int > & marks,
+         unsigned int & drawnCount,
+         unsigned int count,
+         RandomGenerator & generator
+         );
+
+      void collectSources(
+         std::vector< InterruptManager * > & managers,
+         std::vector< std::pair< InterruptManager *, unsigned int > > & sources
+         );
+
+      // Checks if interrupt handled by the last step left components
+      // unchanged, so test does not have to be called;
+      bool isStepMasked();
+
+      // Steps over interrupts until test fails or there are no interrupts;
+      bool runToFailure();
+
+      // The same, but stops before the first interrupt later than time;
+      bool runToFailure( double time );
+
+      // Runs to failure of inspected engine, negative time is unbounded;
+      bool inspectToFailure( double time );
+
+      // The same as runToFailure(), but tests only after jumps of 1, 2,
+      // 4, ... interrupts, and failed jump is bisected by undoing and
+      // simulating its interrupts again;
+      bool bisectToFailure();
+      bool isBisectable();
+
+      // Splitting replica is started from replica path[ 0 ].first and
+      // continued by branches path[ 1 ].first, ..., handling
+      // path[ i ].second interrupts in each of them. Interrupted sources
+      // are hashed in the order they are handled;
+      struct SplittingState
+         {
+         std::vector< std::pair< uint32_t, unsigned int > > path;
+         bool failed;
+         uint64_t sourcesHash;
+         };
+
+      // Restores components and interrupts of the state, returns false
+      // if replay has not interrupted the same sources;
+      bool replayState( const SplittingState & state );
+      void stepState( uint64_t & sourcesHash );
+
+      // Steps over interrupts until time, returns true if score reaches
+      // level or test fails. Handled interrupts are added to the last
+      // step of path;
+      bool runToLevel( double time, double level, CustomFunction * scoreFunction, SplittingState & state );
+      // Failure probability by plain simulation, used where splitting
+      // does not apply;
+      Estimate estimateFailureBySurvival( double time, unsigned int times );
+      double getScore( CustomFunction * scoreFunction );
+      bool isSplittable();
+
+      // Rounds replicas count to whole randomizations of sampling plan
+      // and skips to the beginning of randomization;
+      unsigned int startReplicas( unsigned int times );
+
+      // Estimates mean of replica values, binomial values of unbiased
+      // pseudo-random replicas get Agresti-Coull interval;
+      Estimate estimateMean( const std::vector< double > & values, bool binomial );
+
+      // The same adjusted by control variates, replicas of one
+      // randomization are averaged before regression;
+      Estimate estimateMean(
+         const std::vector< double > & values,
+         const std::vector< double > & controls,
+         double controlMean
+         );
+
+      // Mean of control variate of engine, negative if it is not used;
+      double getControlMean();
+
+      // Control variate of current replica, it has to be taken before
+      // interrupts are handled;
+      double getControl();
+
+      // Returns false when budget is spent or at the end of batch with
+      // precise enough estimate. Precision of probability refers to the
+      // less probable outcome;
+      bool needReplicas(
+         const std::vector< double > & values,
+         unsigned int budget,
+         bool binomial,
+         bool probability
+         );
+
+      // Loads values of matching checkpoint and skips engine to the
+      // first replica not finished yet, stride is values per replica;
+      void openCheckpoint(
+         CHECKPOINT_KIND kind,
+         double parameter,
+         unsigned int budget,
+         unsigned int stride,
+         std::vector< double > & values
+         );
+
+      // Called after every replica, saves values if interval is over or
+      // signal is caught. Caught signal is raised again after saving;
+      void updateCheckpoint( const std::vector< double > & values );
+
+      // Estimate is finished, so checkpoint is removed;
+      void closeCheckpoint();
+
+      bool saveCheckpoint( const std::vector< double > & values );
+
+      // Hash of managers and their distributions, so checkpoint of
+      // another model is not loaded;
+      uint64_t getModelFingerprint();
+
+      SimulationEngine * engine;
+      CustomFunction * testFunction;
+
+      double precision;
+      unsigned int batchSize;
+
+      // Failure of the last replica run is detected at failureTime and
+      // took place after lowerTime, which is the same time unless engine
+      // is inspected;
+      double failureTime;
+      double lowerTime;
+
+      // Header of checkpoint of the running estimate;
+      bool checkpointing;
+      uint32_t checkpointTag;
+      uint32_t checkpointKind;
+      double checkpointParameter;
+      uint32_t checkpointBudget;
+      uint32_t checkpointStride;
+      uint64_t checkpointSeed;
+      uint64_t checkpointFingerprint;
+      uint32_t firstReplica;
+      time_t checkpointTime;
+
+      void ( * previousIntHandler )( int );
+      void ( * previousTermHandler )( int );
+   };
+
+
+#endif
@@ -0,0 +1,278 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#include "engine/ReplicaRunner.h"
+
+
+/***************************************************************************
+ *   ReplicaRunner class implementation                                    *
+ ***************************************************************************/
+
+
+ReplicaRunner::ReplicaRunner( unsigned int threadsCount )
+   {
+   this->seed = 0;
+   this->nextReplica = 0;
+   this->plan = NULL;
+   this->stopped = false;
+
+   // Two slots per thread keep workers busy while replica is simulated;
+   this->slots.resize( 2 * threadsCount );
+   for ( unsigned int i = 0; i < this->slots.size(); i ++ )
+      {
+      this->slots[ i ].replica = i;
+      this->slots[ i ].state = EMPTY;
+      }
+
+   // Start worker threads;
+   for ( unsigned int i = 0; i < threadsCount; i ++ )
+      {
+      this->threads.push_back( std::thread( work, this ) );
+      }
+   };
+
+
+ReplicaRunner::~ReplicaRunner()
+   {
+   // Stop worker threads;
+   std::unique_lock < std::mutex > lock( this->mutex );
+   this->stopped = true;
+   lock.unlock();
+   this->slotsChanged.notify_all();
+
+   for ( unsigned int i = 0; i < this->threads.size(); i ++ )
+      {
+      this->threads[ i ].join();
+      }
+
+   this->freeSlots();
+   };
+
+
+unsigned int ReplicaRunner::getThreadsCount() const
+   {
+   return this->threads.size();
+   };
+
+
+void ReplicaRunner::reset(
+   std::vector< InterruptManager * > & managers,
+   uint64_t seed,
+   uint32_t firstReplica,
+   SamplingPlan * plan
+   )
+   {
+   std::unique_lock < std::mutex > lock( this->mutex );
+
+   // Workers use sources without lock, so wait for them to finish;
+   while ( this->isBusy() ) this->slotsChanged.wait( lock );
+
+   this->freeSlots();
+   this->seed = seed;
+   this->nextReplica = firstReplica;
+   this->plan = plan;
+
+   // Capture object;
+   if ( plan != NULL ) plan->capture();
+
+   // Only managers with thread-safe distributions are sampled by workers,
+   // the rest keep generating interrupts by themselves. Lazy managers
+   // sample one interrupt at a time, so there is nothing to prepare.
+   // Coordinates of the plan are numbered through all the sources;
+   uint32_t dimension = 0;
+   for ( unsigned int i = 0; i < managers.size(); i ++ )
+      {
+      Source source;
+      source.distribution = NULL;
+      source.count = 0;
+      source.dimension = dimension;
+
+      if ( managers[ i ] != NULL ) dimension += managers[ i ]->getIntSourcesCount();
+
+      if ( managers[ i ] != NULL &&
+         ! managers[ i ]->isLazySampling() &&
+         managers[ i ]->getDistribution() != NULL &&
+         managers[ i ]->getDistribution()->isThreadSafe()
+         )
+         {
+         source.distribution = managers[ i ]->getDistribution();
+         source.count = managers[ i ]->getIntSourcesCount();
+
+         // Capture object;
+         source.distribution->capture();
+         }
+
+      this->sources.push_back( source );
+      }
+
+   // Allocate interrupts for the next replicas;
+   unsigned int slotsCount = this->slots.size();
+   for ( unsigned int i = 0; i < slotsCount; i ++ )
+      {
+      Slot & slot = this->slots[ ( this->nextReplica + i ) % slotsCount ];
+      slot.replica = this->nextReplica + i;
+      slot.state = EMPTY;
+      slot.interrupts.assign( this->sources.size(), NULL );
+
+      for ( unsigned int j = 0; j < this->sources.size(); j ++ )
+         {
+         if ( this->sources[ j ].count > 0 )
+            {
+            slot.interrupts[ j ] = new double[ this->sources[ j ].count ];
+            }
+         }
+      }
+
+   lock.unlock();
+   this->slotsChanged.notify_all();
+   };
+
+
+void ReplicaRunner::loadReplica( std::vector< InterruptManager * > & managers )
+   {
+   std::unique_lock < std::mutex > lock( this->mutex );
+
+   // Engine resets runner on every change of managers;
+   if ( this->slots.size() == 0 || this->sources.size() != managers.size() ) return;
+
+   // Wait for the next replica to be sampled;
+   Slot & slot = this->slots[ this->nextReplica % this->slots.size() ];
+   while ( slot.state != READY ) this->slotsChanged.wait( lock );
+
+   for ( unsigned int i = 0; i < managers.size(); i ++ )
+      {
+      if ( this->sources[ i ].count > 0 )
+         {
+         managers[ i ]->preloadInterrupts( slot.interrupts[ i ] );
+         }
+      }
+
+   // Reuse slot for the replica after the last one prepared;
+   slot.replica += this->slots.size();
+   slot.state = EMPTY;
+   this->nextReplica ++;
+
+   lock.unlock();
+   this->slotsChanged.notify_all();
+   };
+
+
+void ReplicaRunner::work( ReplicaRunner * runner )
+   {
+   std::unique_lock < std::mutex > lock( runner->mutex );
+
+   while ( ! runner->stopped )
+      {
+      // Take the earliest replica waiting for sampling;
+      Slot * slot = NULL;
+      unsigned int slotsCount = runner->slots.size();
+      for ( unsigned int i = 0; i < slotsCount; i ++ )
+         {
+         Slot & candidate = runner->slots[ ( runner->nextReplica + i ) % slotsCount ];
+         if ( candidate.state == EMPTY )
+            {
+            slot = & candidate;
+            break;
+            }
+         }
+
+      if ( slot == NULL )
+         {
+         runner->slotsChanged.wait( lock );
+         continue;
+         }
+
+      slot->state = BUSY;
+      lock.unlock();
+
+      runner->sampleReplica( slot );
+
+      lock.lock();
+      slot->state = READY;
+      runner->slotsChanged.notify_all();
+      }
+   };
+
+
+void ReplicaRunner::sampleReplica( Slot * slot )
+   {
+   for ( unsigned int i = 0; i < this->sources.size(); i ++ )
+      {
+      if ( this->sources[ i ].count == 0 ) continue;
+
+      if ( this->plan != NULL )
+         {
+         this->sources[ i ].distribution->generateTimes(
+            * this->plan,
+            this->seed,
+            slot->replica,
+            this->sources[ i ].dimension,
+            this->sources[ i ].count,
+            slot->interrupts[ i ]
+            );
+         }
+      else
+         {
+         RandomGenerator generator( this->seed, slot->replica, i );
+
+         this->sources[ i ].distribution->generateTimes(
+            generator,
+            this->sources[ i ].count,
+            slot->interrupts[ i ]
+            );
+         }
+      }
+   };
+
+
+void ReplicaRunner::freeSlots()
+   {
+   for ( unsigned int i = 0; i < this->slots.size(); i ++ )
+      {
+      for ( unsigned int j = 0; j < this->slots[ i ].interrupts.size(); j ++ )
+         {
+         if ( this->slots[ i ].interrupts[ j ] != NULL ) delete[] this->slots[ i ].interrupts[ j ];
+         }
+
+      this->slots[ i ].interrupts.clear();
+      }
+
+   // Release captured objects;
+   for ( unsigned int i = 0; i < this->sources.size(); i ++ )
+      {
+      if ( this->sources[ i ].distribution != NULL ) this->sources[ i ].distribution->release();
+      }
+
+   this->sources.clear();
+
+   if ( this->plan != NULL ) this->plan->release();
+   this->plan = NULL;
+   };
+
+
+bool ReplicaRunner::isBusy()
+   {
+   for ( unsigned int i = 0; i < this->slots.size(); i ++ )
+      {
+      if ( this->slots[ i ].state == BUSY ) return true;
+      }
+
+   return false;
+   };
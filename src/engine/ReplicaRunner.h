@@ -0,0 +1,112 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#ifndef REPLICARUNNER_H
+#define REPLICARUNNER_H
+
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+#include "engine/InterruptManager.h"
+#include "math/RandomGenerator.h"
+#include "math/SamplingPlan.h"
+
+
+/***************************************************************************
+ *   ReplicaRunner class declaration                                       *
+ ***************************************************************************/
+
+
+// Samples interrupts of upcoming replicas on a pool of worker threads.
+// Replicas are handed out strictly in order and manager i of replica r
+// is sampled from stream ( seed, r, i ) or from sampling plan, exactly as
+// the manager would do by itself, so results do not depend on threads
+// count or scheduling;
+class ReplicaRunner
+   {
+   public:
+      ReplicaRunner( unsigned int threadsCount );
+      virtual ~ReplicaRunner();
+
+      unsigned int getThreadsCount() const;
+
+      // Drops prepared replicas and starts sampling for new managers
+      // from the given replica on, plan may be NULL;
+      void reset(
+         std::vector< InterruptManager * > & managers,
+         uint64_t seed,
+         uint32_t firstReplica,
+         SamplingPlan * plan
+         );
+
+      // Preloads interrupts of the next replica into managers;
+      void loadReplica( std::vector< InterruptManager * > & managers );
+
+   private:
+      enum SLOT_STATE
+         {
+         EMPTY,
+         BUSY,
+         READY
+         };
+
+      struct Slot
+         {
+         uint32_t replica;
+         SLOT_STATE state;
+         std::vector< double * > interrupts;
+         };
+
+      struct Source
+         {
+         Distribution * distribution;
+         unsigned int count;
+         uint32_t dimension;
+         };
+
+      ReplicaRunner();
+      ReplicaRunner( const ReplicaRunner & other );
+      ReplicaRunner & operator =( const ReplicaRunner & other );
+
+      static void work( ReplicaRunner * runner );
+
+      void sampleReplica( Slot * slot );
+      void freeSlots();
+      bool isBusy();
+
+      uint64_t seed;
+      uint32_t nextReplica;
+      SamplingPlan * plan;
+      bool stopped;
+
+      std::vector< Source > sources;
+      std::vector< Slot > slots;
+      std::vector< std::thread > threads;
+
+      std::mutex mutex;
+      std::condition_variable slotsChanged;
+   };
+
+
+#endif
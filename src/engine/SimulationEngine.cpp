@@ -21,6 +21,14 @@
 #include "engine/SimulationEngine.h"
 
 
+#include <math.h>
+#include <stdlib.h>
+
+
+// Branch streams of managers have the highest bit of stream index set;
+static const uint32_t BRANCH_STREAM = 0x80000000U;
+
+
 /***************************************************************************
  *   SimulationEngine class implementation                                 *
  ***************************************************************************/
@@ -31,16 +39,56 @@ SimulationEngine::SimulationEngine()
    this->currentTime = 0.0;
    this->currentIntSource = NULL;
    this->futureIntSource = NULL;
+   this->futureSlot = -1;
+   this->calendar = NULL;
+   this->runner = NULL;
+
+   // Seed is taken from the global generator until it is set explicitly;
+   this->seed = rand();
+   this->replica = 0;
+
+   // Replicas are pseudo-random by default;
+   this->plan = NULL;
+
+   // Checkpoints are disabled by default;
+   this->checkpointInterval = 0;
+
+   // Every interrupt is inspected by default;
+   this->inspectionPeriod = 0.0;
+   this->inspectionFaults = 0;
+
+   // Every interrupt is tested by default;
+   this->bisection = false;
+
+   // Control variate is disabled by default;
+   this->controlManager = NULL;
+   this->controlFaults = 0;
+
+   // Memo is disabled by default;
+   this->memoHits = 0;
+   this->memoMisses = 0;
+   this->faultsHash = 0;
+   this->skippedTests = 0;
    };
 
 
 SimulationEngine::~SimulationEngine()
    {
+   // Stop worker threads before managers are released;
+   if ( this->runner != NULL ) delete this->runner;
+
+   this->detachManagers();
+   if ( this->calendar != NULL ) delete this->calendar;
+
    for ( int i = this->managers.size() - 1; i >= 0; i -- )
       {
       // Release captured object;
       if ( this->managers[ i ] != NULL ) this->managers[ i ]->release();
       }
+
+   // Release captured object;
+   if ( this->plan != NULL ) this->plan->release();
+   if ( this->controlManager != NULL ) this->controlManager->release();
    };
 
 
@@ -54,7 +102,9 @@ void SimulationEngine::appendManager( InterruptManager * manager )
    // Capture object;
    if ( manager != NULL ) manager->capture();
 
+   this->detachManagers();
    this->managers.push_back( manager );
+   this->attachManagers();
    };
 
 
@@ -70,7 +120,12 @@ void SimulationEngine::insertManagerBefore( unsigned int index, InterruptManager
       // throw SimulationEngineExcp( NS_SIMULATIONENGINE::NULL_PARAMETER );
       }
 
+   // Capture object;
+   if ( manager != NULL ) manager->capture();
+
+   this->detachManagers();
    this->managers.insert( this->managers.begin() + index, manager );
+   this->attachManagers();
    };
 
 
@@ -81,40 +136,343 @@ void SimulationEngine::deleteManager( unsigned int index )
       // throw SimulationEngineExcp( NS_SIMULATIONENGINE::INDEX_OUT_OF_RANGE );
       }
 
-   // Release captured object;
-   this->managers[ index ]->release();
+   this->detachManagers();
+
+   // Release captured object, manager does not need engine plan anymore;
+   if ( this->managers[ index ] != NULL )
+      {
+      this->managers[ index ]->setSamplingPlan( NULL, 0 );
+      this->managers[ index ]->release();
+      }
 
    this->managers.erase( this->managers.begin() + index );
+   this->attachManagers();
    };
 
 
 void SimulationEngine::clear()
    {
+   this->detachManagers();
+
+   for ( int i = this->managers.size() - 1; i >= 0; i -- )
+      {
+      // Release captured object, manager does not need engine plan anymore;
+      if ( this->managers[ i ] != NULL )
+         {
+         this->managers[ i ]->setSamplingPlan( NULL, 0 );
+         this->managers[ i ]->release();
+         }
+      }
+
    this->managers.clear();
+   this->attachManagers();
    this->currentTime = 0.0;
    this->currentIntSource = NULL;
    this->futureIntSource = NULL;
    };
 
 
+unsigned int SimulationEngine::getManagersCount() const
+   {
+   return this->managers.size();
+   };
+
+
+InterruptManager * SimulationEngine::getManager( unsigned int index )
+   {
+   return ( index < this->managers.size() ) ? this->managers[ index ] : NULL;
+   };
+
+
 void SimulationEngine::restart()
    {
-   // Reinit all the managers;
-   for ( int i = this->managers.size() - 1; i >= 0; i -- )
+   this->replica ++;
+   this->startReplica();
+   };
+
+
+void SimulationEngine::setSeed( uint64_t seed )
+   {
+   this->seed = seed;
+   this->replica = 0;
+
+   if ( this->runner != NULL ) this->runner->reset( this->managers, this->seed, this->replica, this->plan );
+   this->startReplica();
+   };
+
+
+uint64_t SimulationEngine::getSeed() const
+   {
+   return this->seed;
+   };
+
+
+void SimulationEngine::setThreadsCount( unsigned int threadsCount )
+   {
+   if ( this->runner != NULL )
       {
-      if ( this->managers[ i ] != NULL ) this->managers[ i ]->reinit();
+      if ( this->runner->getThreadsCount() == threadsCount ) return;
+
+      delete this->runner;
+      this->runner = NULL;
+      }
+
+   if ( threadsCount > 0 )
+      {
+      this->runner = new ReplicaRunner( threadsCount );
+      this->runner->reset( this->managers, this->seed, this->replica + 1, this->plan );
+      }
+   };
+
+
+void SimulationEngine::setSamplingPlan( SamplingPlan * plan )
+   {
+   // Capture object;
+   if ( plan != NULL ) plan->capture();
+
+   // Runner has to drop the old plan before it is released;
+   if ( this->runner != NULL ) this->runner->reset( this->managers, this->seed, 0, plan );
+   if ( this->plan != NULL ) this->plan->release();
+
+   this->plan = plan;
+   this->replica = 0;
+   this->startReplica();
+   };
+
+
+SamplingPlan * SimulationEngine::getSamplingPlan()
+   {
+   return this->plan;
+   };
+
+
+unsigned int SimulationEngine::getPointsCount() const
+   {
+   return ( this->plan != NULL ) ? this->plan->getPointsCount() : 1;
+   };
+
+
+void SimulationEngine::startRandomization()
+   {
+   unsigned int pointsCount = this->getPointsCount();
+   if ( this->replica % pointsCount == 0 ) return;
+
+   this->setReplica( this->replica + pointsCount - this->replica % pointsCount );
+   };
+
+
+void SimulationEngine::setReplica( uint32_t replica )
+   {
+   this->replica = replica;
+
+   if ( this->runner != NULL ) this->runner->reset( this->managers, this->seed, this->replica, this->plan );
+   this->startReplica();
+   };
+
+
+uint32_t SimulationEngine::getReplica() const
+   {
+   return this->replica;
+   };
+
+
+void SimulationEngine::branchReplica( uint32_t replica )
+   {
+   for ( unsigned int i = 0; i < this->managers.size(); i ++ )
+      {
+      if ( this->managers[ i ] != NULL )
+         {
+         this->managers[ i ]->setRandomStream( this->seed, replica, BRANCH_STREAM | i );
+         this->managers[ i ]->resampleInterrupts( this->currentTime );
+         }
       }
 
-   this->currentTime = 0.0;
-   this->currentIntSource = NULL;
    this->futureIntSource = NULL;
    };
 
 
+void SimulationEngine::setCheckpoint( const char * fileName, unsigned int interval )
+   {
+   this->checkpointFile = ( fileName != NULL ) ? fileName : "";
+   this->checkpointInterval = interval;
+   };
+
+
+const std::string & SimulationEngine::getCheckpointFile() const
+   {
+   return this->checkpointFile;
+   };
+
+
+unsigned int SimulationEngine::getCheckpointInterval() const
+   {
+   return this->checkpointInterval;
+   };
+
+
+void SimulationEngine::setInspection( double period, unsigned int faultsPeriod )
+   {
+   this->inspectionPeriod = ( period > 0.0 ) ? period : 0.0;
+   this->inspectionFaults = faultsPeriod;
+   };
+
+
+double SimulationEngine::getInspectionPeriod() const
+   {
+   return this->inspectionPeriod;
+   };
+
+
+unsigned int SimulationEngine::getInspectionFaults() const
+   {
+   return this->inspectionFaults;
+   };
+
+
+bool SimulationEngine::isInspected() const
+   {
+   return this->inspectionPeriod > 0.0 || this->inspectionFaults > 0;
+   };
+
+
+void SimulationEngine::setBisection( bool bisection )
+   {
+   this->bisection = bisection;
+   };
+
+
+bool SimulationEngine::isBisected() const
+   {
+   return this->bisection;
+   };
+
+
+void SimulationEngine::setControlVariate( InterruptManager * manager, unsigned int faultsCount )
+   {
+   // Capture object;
+   if ( manager != NULL ) manager->capture();
+
+   // Release captured object;
+   if ( this->controlManager != NULL ) this->controlManager->release();
+
+   this->controlManager = manager;
+   this->controlFaults = faultsCount;
+   };
+
+
+InterruptManager * SimulationEngine::getControlManager()
+   {
+   return this->controlManager;
+   };
+
+
+unsigned int SimulationEngine::getControlFaults() const
+   {
+   return this->controlFaults;
+   };
+
+
+void SimulationEngine::setMemoCapacity( unsigned int capacity )
+   {
+   // Table size is a power of two, so hash is reduced by mask;
+   unsigned int size = 0;
+   if ( capacity > 0 )
+      {
+      size = 1;
+      while ( size < capacity && size < 0x80000000u ) size <<= 1;
+      }
+
+   this->memo.assign( size, MemoEntry() );
+   this->clearMemo();
+   };
+
+
+unsigned int SimulationEngine::getMemoCapacity() const
+   {
+   return this->memo.size();
+   };
+
+
+void SimulationEngine::clearMemo()
+   {
+   for ( unsigned int i = 0; i < this->memo.size(); i ++ ) this->memo[ i ].used = false;
+
+   this->memoHits = 0;
+   this->memoMisses = 0;
+   };
+
+
+bool SimulationEngine::findMemo( bool & result )
+   {
+   if ( this->memo.empty() ) return false;
+
+   const MemoEntry & entry = this->memo[ this->faultsHash & ( this->memo.size() - 1 ) ];
+   if ( entry.used && entry.faultsHash == this->faultsHash && entry.faultsCount == this->faults.size() )
+      {
+      result = entry.result;
+      this->memoHits ++;
+      return true;
+      }
+
+   this->memoMisses ++;
+   return false;
+   };
+
+
+void SimulationEngine::storeMemo( bool result )
+   {
+   if ( this->memo.empty() ) return;
+
+   // Colliding entry is replaced;
+   MemoEntry & entry = this->memo[ this->faultsHash & ( this->memo.size() - 1 ) ];
+   entry.faultsHash = this->faultsHash;
+   entry.faultsCount = this->faults.size();
+   entry.result = result;
+   entry.used = true;
+   };
+
+
+unsigned int SimulationEngine::getMemoHits() const
+   {
+   return this->memoHits;
+   };
+
+
+unsigned int SimulationEngine::getMemoMisses() const
+   {
+   return this->memoMisses;
+   };
+
+
+void SimulationEngine::countSkippedTest()
+   {
+   this->skippedTests ++;
+   };
+
+
+void SimulationEngine::resetSkippedTests()
+   {
+   this->skippedTests = 0;
+   };
+
+
+unsigned int SimulationEngine::getSkippedTests() const
+   {
+   return this->skippedTests;
+   };
+
+
+unsigned int SimulationEngine::getThreadsCount() const
+   {
+   return ( this->runner != NULL ) ? this->runner->getThreadsCount() : 0;
+   };
+
+
 bool SimulationEngine::stepOver()
    {
    InterruptManager * manager = futureIntSource;
    if ( manager == NULL ) manager = findOutIntSource();
+   unsigned int slot = this->futureSlot;
 
    // Clear future interrupt source;
    futureIntSource = NULL;
@@ -125,6 +483,10 @@ bool SimulationEngine::stepOver()
       this->currentTime = manager->getInterrupt();
       this->currentIntSource = manager;
       manager->handleInterrupt();
+
+      // Faults are tracked only for memo;
+      if ( ! this->memo.empty() ) this->recordFault( slot, manager->getLastIntSource() );
+
       return true;
       }
 
@@ -132,6 +494,56 @@ bool SimulationEngine::stepOver()
    };
 
 
+unsigned int SimulationEngine::stepUntil( double time )
+   {
+   unsigned int eventsCount = 0;
+
+   while ( true )
+      {
+      double futureTime = this->getFutureTime();
+      if ( futureTime < 0.0 || futureTime > time ) break;
+
+      this->stepOver();
+      eventsCount ++;
+      }
+
+   return eventsCount;
+   };
+
+
+unsigned int SimulationEngine::stepEvents( unsigned int count )
+   {
+   unsigned int eventsCount = 0;
+
+   while ( eventsCount < count && this->stepOver() ) eventsCount ++;
+
+   return eventsCount;
+   };
+
+
+bool SimulationEngine::isBiased() const
+   {
+   for ( unsigned int i = 0; i < this->managers.size(); i ++ )
+      {
+      if ( this->managers[ i ] != NULL && this->managers[ i ]->getBias() != 1.0 ) return true;
+      }
+
+   return false;
+   };
+
+
+double SimulationEngine::getLikelihoodRatio( double time )
+   {
+   double logRatio = 0.0;
+   for ( unsigned int i = 0; i < this->managers.size(); i ++ )
+      {
+      if ( this->managers[ i ] != NULL ) logRatio += this->managers[ i ]->getLogLikelihoodRatio( time );
+      }
+
+   return exp( logRatio );
+   };
+
+
 double SimulationEngine::getCurrentTime()
    {
    return this->currentTime;
@@ -158,39 +570,118 @@ InterruptManager * SimulationEngine::getFutureIntSource()
    };
 
 
+void SimulationEngine::interruptChanged( InterruptManager * manager, unsigned int slot )
+   {
+   // Reschedule manager, negative time masks it;
+   if ( this->calendar != NULL ) this->calendar->update( slot, manager->getInterrupt() );
+   };
+
+
 InterruptManager * SimulationEngine::findOutIntSource()
    {
-   double min = -1.0;
-   int winner = -1;
+   int winner = ( this->calendar != NULL ) ? this->calendar->getTop() : -1;
+   this->futureSlot = winner;
+   return ( winner >= 0 ) ? this->managers[ winner ] : NULL;
+   };
+
+
+void SimulationEngine::detachManagers()
+   {
+   for ( unsigned int i = 0; i < this->managers.size(); i ++ )
+      {
+      if ( this->managers[ i ] != NULL ) this->managers[ i ]->detachObserver( this );
+      }
+   };
+
 
-   int i = this->managers.size() - 1;
+void SimulationEngine::attachManagers()
+   {
+   if ( this->calendar != NULL ) delete this->calendar;
+   // Equal times are handled from the last manager;
+   this->calendar = new IndexedHeap( this->managers.size(), true );
 
-   // Initialize minimum;
-   while ( i >= 0 )
+   // Fill calendar with the earliest interrupts of managers;
+   for ( unsigned int i = 0; i < this->managers.size(); i ++ )
       {
-      if ( this->managers[ i ]->getInterrupt() >= 0.0 )
+      if ( this->managers[ i ] != NULL )
          {
-         min = this->managers[ i ]->getInterrupt();
-         winner = i;
-         break;
+         this->managers[ i ]->attachObserver( this, i );
+         this->calendar->getKeys()[ i ] = this->managers[ i ]->getInterrupt();
          }
-
-      i --;
       }
 
-   // Search for minimum;
-   double currentInt = -1.0;
-   while ( i >= 0 )
+   this->calendar->build();
+
+   // Forget cached future interrupt source;
+   this->futureIntSource = NULL;
+
+   // Results were tested for previous managers;
+   this->failedSources.clear();
+   this->faults.clear();
+   this->faultsHash = 0;
+   this->clearMemo();
+
+   // Drop replicas sampled for previous managers;
+   if ( this->runner != NULL ) this->runner->reset( this->managers, this->seed, this->replica + 1, this->plan );
+   };
+
+
+void SimulationEngine::startReplica()
+   {
+   // Coordinates of the plan are numbered through all the sources;
+   uint32_t dimension = 0;
+   for ( unsigned int i = 0; i < this->managers.size(); i ++ )
       {
-      currentInt = this->managers[ i ]->getInterrupt();
-      if ( currentInt >= 0.0 && currentInt < min )
+      if ( this->managers[ i ] != NULL )
          {
-         min = currentInt;
-         winner = i;
+         this->managers[ i ]->setRandomStream( this->seed, this->replica, i );
+         this->managers[ i ]->setSamplingPlan( this->plan, dimension );
+         dimension += this->managers[ i ]->getIntSourcesCount();
          }
+      }
+
+   // Take interrupts sampled by worker threads;
+   if ( this->runner != NULL ) this->runner->loadReplica( this->managers );
 
-      i --;
+   // Reinit all the managers;
+   for ( int i = this->managers.size() - 1; i >= 0; i -- )
+      {
+      if ( this->managers[ i ] != NULL ) this->managers[ i ]->reinit();
       }
 
-   return ( winner >= 0 ) ? this->managers[ winner ] : NULL;
+   // Forget failed sources of previous replica;
+   for ( unsigned int i = 0; i < this->faults.size(); i ++ )
+      {
+      this->failedSources[ this->faults[ i ].first ][ this->faults[ i ].second ] = false;
+      }
+
+   this->faults.clear();
+   this->faultsHash = 0;
+
+   this->currentTime = 0.0;
+   this->currentIntSource = NULL;
+   this->futureIntSource = NULL;
+   };
+
+
+void SimulationEngine::recordFault( unsigned int index, int intSource )
+   {
+   if ( intSource < 0 ) return;
+
+   if ( this->failedSources.size() <= index ) this->failedSources.resize( index + 1 );
+
+   std::vector< bool > & failed = this->failedSources[ index ];
+   if ( failed.size() <= ( unsigned int ) intSource ) failed.resize( intSource + 1, false );
+
+   // Regenerated source fails again without changing the set;
+   if ( failed[ intSource ] ) return;
+
+   failed[ intSource ] = true;
+   this->faults.push_back( std::make_pair( index, ( unsigned int ) intSource ) );
+
+   // Key of source is a hash of its manager index and source index;
+   uint64_t key = ( ( uint64_t ) index << 32 | ( uint32_t ) intSource ) + 0x9e3779b97f4a7c15ULL;
+   key = ( key ^ ( key >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+   key = ( key ^ ( key >> 27 ) ) * 0x94d049bb133111ebULL;
+   this->faultsHash ^= key ^ ( key >> 31 );
    };
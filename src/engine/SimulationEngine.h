@@ -22,11 +22,14 @@
 #define SIMULATIONENGINE_H
 
 
+#include <string>
 #include <vector>
 
 
 #include "kernel/KernelObject.h"
+#include "engine/IndexedHeap.h"
 #include "engine/InterruptManager.h"
+#include "engine/ReplicaRunner.h"
 
 
 /***************************************************************************
@@ -34,7 +37,7 @@
  ***************************************************************************/
 
 
-class SimulationEngine : public KernelObject
+class SimulationEngine : public KernelObject, public InterruptObserver
    {
    public:
       SimulationEngine();
@@ -44,23 +47,182 @@ class SimulationEngine : public KernelObject
       void insertManagerBefore( unsigned int index, InterruptManager * manager );
       void deleteManager( unsigned int index );
       void clear();
+
+      unsigned int getManagersCount() const;
+      InterruptManager * getManager( unsigned int index );
       void restart();
 
+      // Manager i of replica r generates interrupts from random stream
+      // ( seed, r, i ), setting seed restarts engine from replica 0.
+      // Engines with the same seed and managers order take the same
+      // uniforms in every replica, which gives common random numbers
+      // for parameter sweeps;
+      void setSeed( uint64_t seed );
+      uint64_t getSeed() const;
+
+      // Replica r is restarted from the beginning of its streams, which
+      // is all the state needed to resume simulation at replica r;
+      void setReplica( uint32_t replica );
+      uint32_t getReplica() const;
+
+      // Current replica goes on from the same state with pending
+      // interrupts sampled again from branch streams of given replica,
+      // which are apart from its ordinary streams, so branches of one
+      // state evolve independently. Used by splitting estimates, managers
+      // must neither regenerate faults nor be biased;
+      void branchReplica( uint32_t replica );
+
+      // Estimators save their progress to checkpoint file every interval
+      // seconds and on SIGINT or SIGTERM, and resume from it when started
+      // in the same state. Empty file name disables checkpoints;
+      void setCheckpoint( const char * fileName, unsigned int interval );
+      const std::string & getCheckpointFile() const;
+      unsigned int getCheckpointInterval() const;
+
+      // Estimators look up results of test function in memo keyed by the
+      // set of sources failed in current replica, so the configurations
+      // met in many replicas are tested once. Memo is valid only if test
+      // result depends on that set alone, e.g. managers have no fix
+      // function. Memo keeps at most capacity results, 0 disables it;
+      void setMemoCapacity( unsigned int capacity );
+      unsigned int getMemoCapacity() const;
+      void clearMemo();
+      bool findMemo( bool & result );
+      void storeMemo( bool result );
+      unsigned int getMemoHits() const;
+      unsigned int getMemoMisses() const;
+
+      // Tests skipped by estimators after interrupts which left
+      // components unchanged;
+      void countSkippedTest();
+      void resetSkippedTests();
+      unsigned int getSkippedTests() const;
+
+      // Estimators test the system only at inspections, which take place
+      // at multiples of period and after every faultsPeriod interrupts,
+      // and report failure times censored by the last passed inspection.
+      // Zero period and faultsPeriod test after every interrupt;
+      void setInspection( double period, unsigned int faultsPeriod );
+      double getInspectionPeriod() const;
+      unsigned int getInspectionFaults() const;
+      bool isInspected() const;
+
+      // Estimates of time to fail test after exponentially growing jumps
+      // of interrupts and bisect failed jump to the first failing
+      // interrupt, if the engine is neither inspected nor biased and
+      // faults of its managers only accumulate;
+      void setBisection( bool bisection );
+      bool isBisected() const;
+
+      // Estimates of time to fail and survival function take time of
+      // faultsCount-th interrupt of manager as control variate, if its
+      // mean is known, e.g. for exponential lifetimes, and the engine is
+      // neither inspected nor biased. Zero faultsCount or NULL manager
+      // disables it;
+      void setControlVariate( InterruptManager * manager, unsigned int faultsCount );
+      InterruptManager * getControlManager();
+      unsigned int getControlFaults() const;
+
+      // Replicas are sampled by worker threads if threadsCount > 0;
+      void setThreadsCount( unsigned int threadsCount );
+      unsigned int getThreadsCount() const;
+
+      // Replicas take points of the plan instead of pseudo-random values,
+      // NULL plan restores random sampling. Setting plan restarts engine
+      // from replica 0;
+      void setSamplingPlan( SamplingPlan * plan );
+      SamplingPlan * getSamplingPlan();
+
+      // Replicas of one randomization of the plan, 1 without plan;
+      unsigned int getPointsCount() const;
+
+      // Skips to the first replica of the next randomization unless
+      // current replica is the first one;
+      void startRandomization();
+
       bool stepOver();
 
+      // Handle all the interrupts up to given time and return their count;
+      unsigned int stepUntil( double time );
+
+      // Handle at most count interrupts and return their actual count;
+      unsigned int stepEvents( unsigned int count );
+
+      // Replicas have to be weighted if any manager is biased;
+      bool isBiased() const;
+
+      // Likelihood ratio of events observed up to given time, which
+      // should not be less than current time;
+      double getLikelihoodRatio( double time );
+
       double getCurrentTime();
       double getFutureTime();
       InterruptManager * getCurrentIntSource();
       InterruptManager * getFutureIntSource();
 
+      virtual void interruptChanged( InterruptManager * manager, unsigned int slot );
+
    private:
-      // Most time-consuming operation;
+      // Sets futureSlot too;
       InterruptManager * findOutIntSource();
 
+      // Calendar has to be rebuilt on every change of managers;
+      void detachManagers();
+      void attachManagers();
+
+      // Assigns random streams of current replica and reinits managers;
+      void startReplica();
+
+      // Adds source of manager to the set of failed sources;
+      void recordFault( unsigned int index, int intSource );
+
+      struct MemoEntry
+         {
+         uint64_t faultsHash;
+         unsigned int faultsCount;
+         bool result;
+         bool used;
+         };
+
       std::vector< InterruptManager * > managers;
+
+      // Earliest interrupts of managers are kept in heap, so the next
+      // event is found in O( 1 ) and rescheduled in O( log m );
+      IndexedHeap * calendar;
+
       double currentTime;
       InterruptManager * currentIntSource;
       InterruptManager * futureIntSource;
+
+      // Calendar slot of future interrupt source, found with it;
+      int futureSlot;
+
+      uint64_t seed;
+      uint32_t replica;
+      SamplingPlan * plan;
+
+      ReplicaRunner * runner;
+
+      std::string checkpointFile;
+      unsigned int checkpointInterval;
+
+      double inspectionPeriod;
+      unsigned int inspectionFaults;
+      bool bisection;
+
+      InterruptManager * controlManager;
+      unsigned int controlFaults;
+
+      // Direct mapped table indexed by the hash of failed sources, which
+      // is a xor of their keys, so it is updated in O( 1 ) per fault with
+      // the calendar slot of the manager handling it;
+      std::vector< MemoEntry > memo;
+      unsigned int memoHits;
+      unsigned int memoMisses;
+      unsigned int skippedTests;
+      uint64_t faultsHash;
+      std::vector< std::vector< bool > > failedSources;
+      std::vector< std::pair< unsigned int, unsigned int > > faults;
    };
 
 
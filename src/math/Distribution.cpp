@@ -19,12 +19,15 @@
 
 
 #include <math.h>
-#include <stdlib.h>
 
 
 #include "math/Distribution.h"
 
 
+#include "math/Statistics.h"
+#include "math/VectorMath.h"
+
+
 /***************************************************************************
  *   Distribution abstract class implementation                            *
  ***************************************************************************/
@@ -42,13 +45,127 @@ Distribution::~Distribution()
    };
 
 
-inline double Distribution::genUniformRandomValue()
+double Distribution::generateTime( RandomGenerator & generator )
+   {
+   return inverseFunction( generator.generateUniform() );
+   };
+
+
+double Distribution::generateTimeAfter( RandomGenerator & generator, double time )
+   {
+   if ( ! this->hasDensity() )
+      {
+      // Inverse function is all that is known, so reject earlier times;
+      double t = 0.0;
+      do t = this->generateTime( generator ); while ( t <= time );
+      return t;
+      }
+
+   // Uniform value is taken from [F( time ), 1), so that
+   // 1 - x = S( time ) * ( 1 - u );
+   double u = generator.generateUniform();
+   double x = - expm1( this->logSurvival( time ) + log1p( - u ) );
+   double t = this->inverseFunction( x );
+   return ( t > time ) ? t : time;
+   };
+
+
+void Distribution::generateTimes( RandomGenerator & generator, unsigned int count, double * times )
+   {
+   generator.generateUniforms( count, times );
+   inverseFunctions( count, times );
+   };
+
+
+void Distribution::generateTimes(
+   const SamplingPlan & plan,
+   uint64_t seed,
+   uint32_t replica,
+   uint32_t dimension,
+   unsigned int count,
+   double * times
+   )
+   {
+   plan.generateUniforms( seed, replica, dimension, count, times );
+   inverseFunctions( count, times );
+   };
+
+
+void Distribution::inverseFunctions( unsigned int count, double * x )
+   {
+   for ( unsigned int i = 0; i < count; i ++ ) x[ i ] = inverseFunction( x[ i ] );
+   };
+
+
+bool Distribution::isThreadSafe() const
+   {
+   return true;
+   };
+
+
+bool Distribution::hasDensity() const
+   {
+   return false;
+   };
+
+
+double Distribution::logDensity( double t )
+   {
+   return 0.0;
+   };
+
+
+double Distribution::logSurvival( double t )
    {
-   return (
-      ( ( double ) rand() )
-      /
-      ( ( double ) RAND_MAX )
-      );
+   return 0.0;
+   };
+
+
+double Distribution::orderedMean( unsigned int k, unsigned int n )
+   {
+   if ( k == 0 || k > n ) return -1.0;
+
+   std::vector< double > means;
+   this->orderedMeans( n, means );
+   return means[ k - 1 ];
+   };
+
+
+void Distribution::orderedMeans( unsigned int n, std::vector< double > & means )
+   {
+   means.assign( n, -1.0 );
+   if ( n == 0 || ! this->hasDensity() ) return;
+
+   // Below tLow even the first lifetime is hardly ever found, above tHigh
+   // the last one is;
+   double tLow = this->inverseFunction( 1.0e-10 / n );
+   double tHigh = this->inverseFunction( 1.0 - 1.0e-16 );
+   if ( ! ( tLow > 0.0 ) || ! ( tHigh > tLow ) ) return;
+
+   // Simpson's rule over s = log( t ), where dt = t ds. Integrand is
+   // taken as 1 below tLow;
+   const unsigned int STEPS = 4000;
+   double sLow = log( tLow );
+   double h = ( log( tHigh ) - sLow ) / STEPS;
+   means.assign( n, tLow );
+
+   std::vector< double > pmf;
+   for ( unsigned int i = 0; i <= STEPS; i ++ )
+      {
+      double t = exp( sLow + i * h );
+      double weight = ( i == 0 || i == STEPS ) ? 1.0 : ( ( i % 2 == 1 ) ? 4.0 : 2.0 );
+      weight *= t * h / 3.0;
+
+      calcBinomialDistribution( n, - expm1( this->logSurvival( t ) ), pmf );
+
+      // P( Bin( n, F( t ) ) < k ) for k = 1, ..., n;
+      double survival = 0.0;
+      for ( unsigned int k = 1; k <= n; k ++ )
+         {
+         survival += pmf[ k - 1 ];
+         means[ k - 1 ] += weight * survival;
+         }
+      }
    };
 
 
@@ -81,9 +198,15 @@ CustomDistribution::~CustomDistribution()
    };
 
 
-double CustomDistribution::generateTime()
+double CustomDistribution::inverseFunction( double x )
    {
-   return customInverseFunction->call( genUniformRandomValue() );
+   return customInverseFunction->call( x );
+   };
+
+
+bool CustomDistribution::isThreadSafe() const
+   {
+   return false;
    };
 
 
@@ -105,9 +228,61 @@ ExponentialDistribution::~ExponentialDistribution()
    };
 
 
-double ExponentialDistribution::generateTime()
+double ExponentialDistribution::inverseFunction( double x )
+   {
+   return ( - vectorLog( 1.0 - x ) ) / lambda;
+   };
+
+
+void ExponentialDistribution::inverseFunctions( unsigned int count, double * x )
+   {
+   for ( unsigned int i = 0; i < count; i ++ )
+      {
+      x[ i ] = ( - vectorLog( 1.0 - x[ i ] ) ) / lambda;
+      }
+   };
+
+
+bool ExponentialDistribution::hasDensity() const
    {
-   return ( - log( 1.0 - genUniformRandomValue() ) ) / lambda;
+   return true;
+   };
+
+
+double ExponentialDistribution::logDensity( double t )
+   {
+   return log( lambda ) - lambda * t;
+   };
+
+
+double ExponentialDistribution::logSurvival( double t )
+   {
+   return - lambda * t;
+   };
+
+
+double ExponentialDistribution::orderedMean( unsigned int k, unsigned int n )
+   {
+   if ( k == 0 || k > n ) return -1.0;
+
+   // Spacings are exponential, j survivors fail at rate j * lambda;
+   double mean = 0.0;
+   for ( unsigned int j = n - k + 1; j <= n; j ++ ) mean += 1.0 / j;
+
+   return mean / lambda;
+   };
+
+
+void ExponentialDistribution::orderedMeans( unsigned int n, std::vector< double > & means )
+   {
+   means.resize( n );
+
+   double mean = 0.0;
+   for ( unsigned int k = 1; k <= n; k ++ )
+      {
+      mean += 1.0 / ( n - k + 1 );
+      means[ k - 1 ] = mean / lambda;
+      }
    };
 
 
@@ -121,6 +296,13 @@ WeibullDistribution::WeibullDistribution( double theta, double beta )
    {
    this->theta = theta;
    this->beta = beta;
+
+   // pow( y / theta, 1 / beta ) = exp( ( log( y ) - log( theta ) ) / beta );
+   this->logTheta = log( theta );
+   this->invBeta = 1.0 / beta;
+
+   // S( t ) = exp( - theta * t^beta ) for the inverse function above;
+   this->logThetaBeta = log( theta * beta );
    };
 
 
@@ -130,7 +312,40 @@ WeibullDistribution::~WeibullDistribution()
    };
 
 
-double WeibullDistribution::generateTime()
+double WeibullDistribution::inverseFunction( double x )
+   {
+   double y = - vectorLog( 1.0 - x );
+   double t = vectorExp( ( vectorLog( y ) - logTheta ) * invBeta );
+   return ( y > 0.0 ) ? t : 0.0;
+   };
+
+
+void WeibullDistribution::inverseFunctions( unsigned int count, double * x )
+   {
+   for ( unsigned int i = 0; i < count; i ++ )
+      {
+      double y = - vectorLog( 1.0 - x[ i ] );
+      double t = vectorExp( ( vectorLog( y ) - logTheta ) * invBeta );
+
+      // Logarithm is not defined for zero, so take the limit;
+      x[ i ] = ( y > 0.0 ) ? t : 0.0;
+      }
+   };
+
+
+bool WeibullDistribution::hasDensity() const
+   {
+   return true;
+   };
+
+
+double WeibullDistribution::logDensity( double t )
+   {
+   return logThetaBeta + ( beta - 1.0 ) * log( t ) - theta * pow( t, beta );
+   };
+
+
+double WeibullDistribution::logSurvival( double t )
    {
-   return pow( - log( 1.0 - genUniformRandomValue() ) / theta, 1.0 / beta );
+   return - theta * pow( t, beta );
    };
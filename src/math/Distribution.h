@@ -22,10 +22,12 @@
 #define DISTRIBUTION_H
 
 
-// This module uses random generator;
+#include <vector>
 
 
 #include "kernel/KernelObject.h"
+#include "math/RandomGenerator.h"
+#include "math/SamplingPlan.h"
 #include "objects/CustomFunction.h"
 
 
@@ -55,11 +57,52 @@ class Distribution : public KernelObject
       Distribution();
       virtual ~Distribution();
 
-      virtual double generateTime() = 0;
-
-   protected:
-      // Use rand();
-      inline double genUniformRandomValue();
+      double generateTime( RandomGenerator & generator );
+
+      // Generates time conditioned on being later than given time, i.e.
+      // lifetime of component which has survived until that time.
+      // Distributions without survival function are sampled until later
+      // time comes out;
+      double generateTimeAfter( RandomGenerator & generator, double time );
+
+      // Generates count times at once, the same as count calls of
+      // generateTime() would return;
+      void generateTimes( RandomGenerator & generator, unsigned int count, double * times );
+
+      // Generates times from coordinates of replica point of the plan;
+      void generateTimes(
+         const SamplingPlan & plan,
+         uint64_t seed,
+         uint32_t replica,
+         uint32_t dimension,
+         unsigned int count,
+         double * times
+         );
+
+      // Maps uniform random value from [0, 1) onto distribution;
+      virtual double inverseFunction( double x ) = 0;
+
+      // Maps count uniform random values in place, reimplementation has
+      // to return the same as inverseFunction();
+      virtual void inverseFunctions( unsigned int count, double * x );
+
+      // Distribution may be sampled by worker threads only if true;
+      virtual bool isThreadSafe() const;
+
+      // Density and survival function are needed to weight replicas
+      // sampled from biased distribution;
+      virtual bool hasDensity() const;
+      virtual double logDensity( double t );
+      virtual double logSurvival( double t );
+
+      // Mean of k-th of n ordered lifetimes, k = 1, ..., n, which is
+      // expectation of control variates. Negative if it is not known;
+      virtual double orderedMean( unsigned int k, unsigned int n );
+
+      // Fills means[ k - 1 ] with the same for all k at once. Without
+      // closed form they are integrals of P( Bin( n, F( t ) ) < k ) over
+      // logarithm of time, which needs survival function;
+      virtual void orderedMeans( unsigned int n, std::vector< double > & means );
    };
 
 
@@ -75,7 +118,10 @@ class CustomDistribution : public Distribution
       CustomDistribution( CustomDistribution & other );
       virtual ~CustomDistribution();
 
-      virtual double generateTime();
+      virtual double inverseFunction( double x );
+
+      // Lua virtual machine can not be entered from worker threads;
+      virtual bool isThreadSafe() const;
 
    private:
       CustomDistribution( const CustomDistribution & other );
@@ -95,7 +141,14 @@ class ExponentialDistribution : public Distribution
       ExponentialDistribution( double lambda );
       virtual ~ExponentialDistribution();
 
-      virtual double generateTime();
+      virtual double inverseFunction( double x );
+      virtual void inverseFunctions( unsigned int count, double * x );
+
+      virtual bool hasDensity() const;
+      virtual double logDensity( double t );
+      virtual double logSurvival( double t );
+      virtual double orderedMean( unsigned int k, unsigned int n );
+      virtual void orderedMeans( unsigned int n, std::vector< double > & means );
 
    private:
       double lambda;
@@ -113,11 +166,20 @@ class WeibullDistribution : public Distribution
       WeibullDistribution( double theta, double beta );
       virtual ~WeibullDistribution();
 
-      virtual double generateTime();
+      virtual double inverseFunction( double x );
+      virtual void inverseFunctions( unsigned int count, double * x );
+
+      virtual bool hasDensity() const;
+      virtual double logDensity( double t );
+      virtual double logSurvival( double t );
 
    private:
       double theta;
       double beta;
+
+      double logTheta;
+      double invBeta;
+      double logThetaBeta;
    };
 
 
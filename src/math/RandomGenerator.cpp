@@ -0,0 +1,177 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#include "math/RandomGenerator.h"
+
+
+// Philox4x32 round constants;
+static const uint32_t PHILOX_M0 = 0xD2511F53;
+static const uint32_t PHILOX_M1 = 0xCD9E8D57;
+static const uint32_t PHILOX_W0 = 0x9E3779B9;
+static const uint32_t PHILOX_W1 = 0xBB67AE85;
+
+
+// Computes block of Philox output and maps it onto two uniform values
+// with 53 random bits each;
+static inline void philoxBlock(
+   uint64_t block,
+   uint32_t stream,
+   uint32_t replica,
+   uint64_t seed,
+   double & x0,
+   double & x1
+   )
+   {
+   // Counter holds block number, stream and replica, key holds seed;
+   uint32_t c0 = ( uint32_t ) block;
+   uint32_t c1 = ( uint32_t ) ( block >> 32 );
+   uint32_t c2 = stream;
+   uint32_t c3 = replica;
+   uint32_t k0 = ( uint32_t ) seed;
+   uint32_t k1 = ( uint32_t ) ( seed >> 32 );
+
+   for ( unsigned int i = 0; i < 10; i ++ )
+      {
+      uint64_t product0 = ( uint64_t ) PHILOX_M0 * c0;
+      uint64_t product1 = ( uint64_t ) PHILOX_M1 * c2;
+
+      c0 = ( uint32_t ) ( product1 >> 32 ) ^ c1 ^ k0;
+      c1 = ( uint32_t ) product1;
+      c2 = ( uint32_t ) ( product0 >> 32 ) ^ c3 ^ k1;
+      c3 = ( uint32_t ) product0;
+
+      k0 += PHILOX_W0;
+      k1 += PHILOX_W1;
+      }
+
+   x0 = ( ( ( ( uint64_t ) c0 << 32 ) | c1 ) >> 11 ) * ( 1.0 / 9007199254740992.0 );
+   x1 = ( ( ( ( uint64_t ) c2 << 32 ) | c3 ) >> 11 ) * ( 1.0 / 9007199254740992.0 );
+   };
+
+
+/***************************************************************************
+ *   RandomGenerator class implementation                                  *
+ ***************************************************************************/
+
+
+RandomGenerator::RandomGenerator()
+   {
+   this->setStream( 0, 0, 0 );
+   };
+
+
+RandomGenerator::RandomGenerator( uint64_t seed, uint32_t replica, uint32_t stream )
+   {
+   this->setStream( seed, replica, stream );
+   };
+
+
+RandomGenerator::~RandomGenerator()
+   {
+   // Do nothing;
+   };
+
+
+void RandomGenerator::setStream( uint64_t seed, uint32_t replica, uint32_t stream )
+   {
+   this->seed = seed;
+   this->replica = replica;
+   this->stream = stream;
+   this->position = 0;
+
+   // Nothing is buffered yet;
+   this->bufferedBlock = ~( ( uint64_t ) 0 );
+   };
+
+
+uint64_t RandomGenerator::getSeed() const
+   {
+   return this->seed;
+   };
+
+
+uint32_t RandomGenerator::getReplica() const
+   {
+   return this->replica;
+   };
+
+
+uint32_t RandomGenerator::getStream() const
+   {
+   return this->stream;
+   };
+
+
+uint64_t RandomGenerator::getPosition() const
+   {
+   return this->position;
+   };
+
+
+void RandomGenerator::skipAhead( uint64_t count )
+   {
+   this->position += count;
+   };
+
+
+void RandomGenerator::generateUniforms( unsigned int count, double * values )
+   {
+   unsigned int i = 0;
+
+   // Finish buffered block;
+   if ( ( this->position & 1 ) != 0 && count > 0 ) values[ i ++ ] = this->generateUniform();
+
+   // Generate whole blocks directly into values;
+   uint64_t firstBlock = this->position >> 1;
+   unsigned int blocksCount = ( count - i ) / 2;
+   double * blockValues = values + i;
+   for ( unsigned int j = 0; j < blocksCount; j ++ )
+      {
+      philoxBlock(
+         firstBlock + j,
+         this->stream,
+         this->replica,
+         this->seed,
+         blockValues[ 2 * j ],
+         blockValues[ 2 * j + 1 ]
+         );
+      }
+
+   this->position += 2 * ( uint64_t ) blocksCount;
+   i += 2 * blocksCount;
+
+   // Start the next block;
+   if ( i < count ) values[ i ++ ] = this->generateUniform();
+   };
+
+
+void RandomGenerator::generateBlock( uint64_t block )
+   {
+   philoxBlock(
+      block,
+      this->stream,
+      this->replica,
+      this->seed,
+      this->buffer[ 0 ],
+      this->buffer[ 1 ]
+      );
+
+   this->bufferedBlock = block;
+   };
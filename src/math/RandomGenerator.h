@@ -0,0 +1,84 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#ifndef RANDOMGENERATOR_H
+#define RANDOMGENERATOR_H
+
+
+#include <stdint.h>
+
+
+/***************************************************************************
+ *   RandomGenerator class declaration                                     *
+ ***************************************************************************/
+
+
+// Counter-based Philox4x32-10 generator. Every value is a function of
+// seed, replica, stream and position only, so independent streams need
+// no shared state and any position is reached in O( 1 );
+class RandomGenerator
+   {
+   public:
+      RandomGenerator();
+      RandomGenerator( uint64_t seed, uint32_t replica, uint32_t stream );
+      virtual ~RandomGenerator();
+
+      // Rewinds generator to the beginning of given stream;
+      void setStream( uint64_t seed, uint32_t replica, uint32_t stream );
+
+      uint64_t getSeed() const;
+      uint32_t getReplica() const;
+      uint32_t getStream() const;
+      uint64_t getPosition() const;
+
+      // Skips count uniform values;
+      void skipAhead( uint64_t count );
+
+      // Returns uniform random value from [0, 1) with 53 random bits;
+      inline double generateUniform();
+
+      // Fills values with the next count uniform values, the same as
+      // count calls of generateUniform() would return;
+      void generateUniforms( unsigned int count, double * values );
+
+   private:
+      void generateBlock( uint64_t block );
+
+      uint64_t seed;
+      uint32_t replica;
+      uint32_t stream;
+      uint64_t position;
+
+      // Every block of Philox output gives two uniform values;
+      uint64_t bufferedBlock;
+      double buffer[ 2 ];
+   };
+
+
+inline double RandomGenerator::generateUniform()
+   {
+   uint64_t block = this->position >> 1;
+   if ( block != this->bufferedBlock ) this->generateBlock( block );
+
+   return this->buffer[ this->position ++ & 1 ];
+   };
+
+
+#endif
@@ -0,0 +1,319 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#include "math/SamplingPlan.h"
+
+
+#include "math/RandomGenerator.h"
+
+
+// The largest double below 1.0;
+static const double MAX_UNIFORM = 1.0 - 1.0 / 9007199254740992.0;
+
+
+// Primitive polynomials and initial direction numbers of the second to
+// the fourth Sobol dimension ( Joe and Kuo ), the first one is radical
+// inverse in base 2;
+static const unsigned int SOBOL_DEGREES[ 3 ] = { 1, 2, 3 };
+static const uint32_t SOBOL_POLYNOMIALS[ 3 ] = { 0, 1, 1 };
+static const uint32_t SOBOL_NUMBERS[ 3 ][ 3 ] = { { 1 }, { 1, 3 }, { 1, 3, 1 } };
+
+
+// SplitMix64 finalizer;
+static inline uint64_t mix( uint64_t x )
+   {
+   x ^= x >> 30;
+   x *= 0xBF58476D1CE4E5B9ULL;
+   x ^= x >> 27;
+   x *= 0x94D049BB133111EBULL;
+   x ^= x >> 31;
+   return x;
+   };
+
+
+// Derives independent key for given randomization, dimension and use;
+static inline uint64_t deriveKey(
+   uint64_t seed,
+   uint32_t randomization,
+   uint32_t dimension,
+   uint32_t salt
+   )
+   {
+   uint64_t key = mix( seed + 0x9E3779B97F4A7C15ULL );
+   key = mix( key ^ ( ( ( uint64_t ) randomization << 32 ) | salt ) );
+   return mix( key ^ dimension );
+   };
+
+
+// Maps 53 high bits of hash onto [0, 1);
+static inline double toUniform( uint64_t hash )
+   {
+   return ( hash >> 11 ) * ( 1.0 / 9007199254740992.0 );
+   };
+
+
+// Random permutation of [0, length) keyed by key, Kensler's hash is
+// cycle-walked inside the smallest enclosing power of two;
+static inline uint32_t permute( uint32_t index, uint32_t length, uint32_t key )
+   {
+   uint32_t mask = length - 1;
+   mask |= mask >> 1;
+   mask |= mask >> 2;
+   mask |= mask >> 4;
+   mask |= mask >> 8;
+   mask |= mask >> 16;
+
+   do
+      {
+      index ^= key;
+      index *= 0xE170893D;
+      index ^= key >> 16;
+      index ^= ( index & mask ) >> 4;
+      index ^= key >> 8;
+      index *= 0x0929EB3F;
+      index ^= key >> 23;
+      index ^= ( index & mask ) >> 1;
+      index *= 1 | key >> 27;
+      index *= 0x6935FA69;
+      index ^= ( index & mask ) >> 11;
+      index *= 0x74DCB303;
+      index ^= ( index & mask ) >> 2;
+      index *= 0x9E501CC3;
+      index ^= ( index & mask ) >> 2;
+      index *= 0xC860A3DF;
+      index &= mask;
+      index ^= index >> 5;
+      }
+   while ( index >= length );
+
+   return ( index + key ) % length;
+   };
+
+
+static inline uint32_t reverseBits( uint32_t x )
+   {
+   x = ( ( x >> 1 ) & 0x55555555 ) | ( ( x & 0x55555555 ) << 1 );
+   x = ( ( x >> 2 ) & 0x33333333 ) | ( ( x & 0x33333333 ) << 2 );
+   x = ( ( x >> 4 ) & 0x0F0F0F0F ) | ( ( x & 0x0F0F0F0F ) << 4 );
+   x = ( ( x >> 8 ) & 0x00FF00FF ) | ( ( x & 0x00FF00FF ) << 8 );
+   return ( x >> 16 ) | ( x << 16 );
+   };
+
+
+// Hash-based nested uniform scrambling ( Burley ): every bit is flipped
+// depending on more significant bits only, so the first 2^m points of
+// scrambled sequence are still stratified;
+static inline uint32_t scramble( uint32_t x, uint32_t key )
+   {
+   x = reverseBits( x );
+   x += key;
+   x ^= x * 0x6C50B47C;
+   x ^= x * 0xB82F1E52;
+   x ^= x * 0xC7AFE638;
+   x ^= x * 0x8D22F6E6;
+   return reverseBits( x );
+   };
+
+
+/***************************************************************************
+ *   SamplingPlan abstract class implementation                            *
+ ***************************************************************************/
+
+
+SamplingPlan::SamplingPlan( unsigned int pointsCount )
+   {
+   this->pointsCount = ( pointsCount > 0 ) ? pointsCount : 1;
+   };
+
+
+SamplingPlan::~SamplingPlan()
+   {
+   // Do nothing;
+   };
+
+
+unsigned int SamplingPlan::getPointsCount() const
+   {
+   return this->pointsCount;
+   };
+
+
+/***************************************************************************
+ *   LatinHypercubePlan class implementation                               *
+ ***************************************************************************/
+
+
+LatinHypercubePlan::LatinHypercubePlan( unsigned int pointsCount )
+   : SamplingPlan( pointsCount )
+   {
+   // Do nothing;
+   };
+
+
+LatinHypercubePlan::~LatinHypercubePlan()
+   {
+   // Do nothing;
+   };
+
+
+void LatinHypercubePlan::generateUniforms(
+   uint64_t seed,
+   uint32_t replica,
+   uint32_t dimension,
+   unsigned int count,
+   double * values
+   ) const
+   {
+   uint32_t randomization = replica / this->pointsCount;
+   uint32_t point = replica % this->pointsCount;
+
+   for ( unsigned int i = 0; i < count; i ++ )
+      {
+      // Strata are permuted independently for every coordinate;
+      uint64_t key = deriveKey( seed, randomization, dimension + i, 0 );
+      uint32_t stratum = permute( point, this->pointsCount, ( uint32_t ) key );
+      double jitter = toUniform( mix( key ^ point ) );
+
+      double x = ( stratum + jitter ) / this->pointsCount;
+      values[ i ] = ( x < MAX_UNIFORM ) ? x : MAX_UNIFORM;
+      }
+   };
+
+
+/***************************************************************************
+ *   SobolPlan class implementation                                        *
+ ***************************************************************************/
+
+
+SobolPlan::SobolPlan( unsigned int pointsCount )
+   : SamplingPlan( pointsCount )
+   {
+   for ( unsigned int j = 0; j < 32; j ++ )
+      {
+      this->directions[ 0 ][ j ] = ( uint32_t ) 1 << ( 31 - j );
+      }
+
+   for ( unsigned int i = 1; i < 4; i ++ )
+      {
+      unsigned int degree = SOBOL_DEGREES[ i - 1 ];
+      uint32_t polynomial = SOBOL_POLYNOMIALS[ i - 1 ];
+      uint32_t * v = this->directions[ i ];
+
+      for ( unsigned int j = 0; j < 32; j ++ )
+         {
+         if ( j < degree )
+            {
+            v[ j ] = SOBOL_NUMBERS[ i - 1 ][ j ] << ( 31 - j );
+            continue;
+            }
+
+         v[ j ] = v[ j - degree ] ^ ( v[ j - degree ] >> degree );
+         for ( unsigned int k = 1; k < degree; k ++ )
+            {
+            if ( ( polynomial >> ( degree - 1 - k ) ) & 1 ) v[ j ] ^= v[ j - k ];
+            }
+         }
+      }
+   };
+
+
+SobolPlan::~SobolPlan()
+   {
+   // Do nothing;
+   };
+
+
+void SobolPlan::generateUniforms(
+   uint64_t seed,
+   uint32_t replica,
+   uint32_t dimension,
+   unsigned int count,
+   double * values
+   ) const
+   {
+   uint32_t randomization = replica / this->pointsCount;
+   uint32_t point = replica % this->pointsCount;
+
+   for ( unsigned int i = 0; i < count; i ++ )
+      {
+      uint32_t group = ( dimension + i ) / 4;
+      const uint32_t * v = this->directions[ ( dimension + i ) % 4 ];
+
+      // Coordinates of the same group share shuffled point order;
+      uint32_t index = scramble(
+         point,
+         ( uint32_t ) deriveKey( seed, randomization, group, 1 )
+         );
+
+      uint32_t x = 0;
+      for ( unsigned int j = 0; index != 0; j ++, index >>= 1 )
+         {
+         if ( index & 1 ) x ^= v[ j ];
+         }
+
+      // Scrambled digits beyond the 32nd are independent uniform ones;
+      uint64_t key = deriveKey( seed, randomization, dimension + i, 2 );
+      x = scramble( x, ( uint32_t ) key );
+      uint64_t tail = mix( key ^ point ) >> 43;
+
+      values[ i ] = ( ( ( uint64_t ) x << 21 ) | tail ) * ( 1.0 / 9007199254740992.0 );
+      }
+   };
+
+
+/***************************************************************************
+ *   AntitheticPlan class implementation                                   *
+ ***************************************************************************/
+
+
+AntitheticPlan::AntitheticPlan()
+   : SamplingPlan( 2 )
+   {
+   // Do nothing;
+   };
+
+
+AntitheticPlan::~AntitheticPlan()
+   {
+   // Do nothing;
+   };
+
+
+void AntitheticPlan::generateUniforms(
+   uint64_t seed,
+   uint32_t replica,
+   uint32_t dimension,
+   unsigned int count,
+   double * values
+   ) const
+   {
+   // Both replicas of the pair read the same positions of one stream,
+   // which is apart from the streams of managers;
+   RandomGenerator generator( seed, replica / 2, 0xfffffffeU );
+   generator.skipAhead( dimension );
+   generator.generateUniforms( count, values );
+
+   // Uniforms are multiples of 2^-53, so the twin is their exact
+   // reflection inside [0, 1);
+   if ( replica % 2 == 1 )
+      {
+      for ( unsigned int i = 0; i < count; i ++ ) values[ i ] = MAX_UNIFORM - values[ i ];
+      }
+   };
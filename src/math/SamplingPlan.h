@@ -0,0 +1,156 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#ifndef SAMPLINGPLAN_H
+#define SAMPLINGPLAN_H
+
+
+#include <stdint.h>
+
+
+#include "kernel/KernelObject.h"
+
+
+/***************************************************************************
+ *   T_SAMPLING enum declaration                                           *
+ ***************************************************************************/
+
+namespace SAMPLING
+   {
+   enum T_SAMPLING
+      {
+      RANDOM,
+      LATIN_HYPERCUBE,
+      SOBOL,
+      ANTITHETIC
+      };
+   };
+
+
+/***************************************************************************
+ *   SamplingPlan abstract class declaration                               *
+ ***************************************************************************/
+
+
+// Plan spreads points of randomized point set over replicas: replica r
+// is point r % pointsCount of randomization r / pointsCount, and every
+// interrupt source of the engine takes its own coordinate. Randomizations
+// are independent, so their means give a valid error estimate. Every
+// value is a function of arguments only, so plan may be shared by
+// worker threads;
+class SamplingPlan : public KernelObject
+   {
+   public:
+      SamplingPlan( unsigned int pointsCount );
+      virtual ~SamplingPlan();
+
+      unsigned int getPointsCount() const;
+
+      // Fills values with coordinates dimension, ..., dimension + count - 1
+      // of replica point, each of them is uniform on [0, 1);
+      virtual void generateUniforms(
+         uint64_t seed,
+         uint32_t replica,
+         uint32_t dimension,
+         unsigned int count,
+         double * values
+         ) const = 0;
+
+   protected:
+      unsigned int pointsCount;
+   };
+
+
+/***************************************************************************
+ *   LatinHypercubePlan class declaration                                  *
+ ***************************************************************************/
+
+
+// Every coordinate of pointsCount points hits each of pointsCount equal
+// strata exactly once;
+class LatinHypercubePlan : public SamplingPlan
+   {
+   public:
+      LatinHypercubePlan( unsigned int pointsCount );
+      virtual ~LatinHypercubePlan();
+
+      virtual void generateUniforms(
+         uint64_t seed,
+         uint32_t replica,
+         uint32_t dimension,
+         unsigned int count,
+         double * values
+         ) const;
+   };
+
+
+/***************************************************************************
+ *   SobolPlan class declaration                                           *
+ ***************************************************************************/
+
+
+// Owen-scrambled Sobol points. Engine may have far more sources than
+// direction numbers are known for, so coordinates are taken by groups
+// of four from the first Sobol dimensions with independently shuffled
+// point order. Points count should be a power of two;
+class SobolPlan : public SamplingPlan
+   {
+   public:
+      SobolPlan( unsigned int pointsCount );
+      virtual ~SobolPlan();
+
+      virtual void generateUniforms(
+         uint64_t seed,
+         uint32_t replica,
+         uint32_t dimension,
+         unsigned int count,
+         double * values
+         ) const;
+
+   private:
+      uint32_t directions[ 4 ][ 32 ];
+   };
+
+
+/***************************************************************************
+ *   AntitheticPlan class declaration                                      *
+ ***************************************************************************/
+
+
+// Pairs of replicas: the first one takes pseudo-random uniforms u and
+// its antithetic twin takes 1 - u, so monotone responses of the pair
+// are negatively correlated;
+class AntitheticPlan : public SamplingPlan
+   {
+   public:
+      AntitheticPlan();
+      virtual ~AntitheticPlan();
+
+      virtual void generateUniforms(
+         uint64_t seed,
+         uint32_t replica,
+         uint32_t dimension,
+         unsigned int count,
+         double * values
+         ) const;
+   };
+
+
+#endif
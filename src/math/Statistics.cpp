@@ -0,0 +1,354 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#include "math/Statistics.h"
+
+
+#include <algorithm>
+#include <math.h>
+
+
+/***************************************************************************
+ *   Confidence intervals functions implementation                         *
+ ***************************************************************************/
+
+
+double calcMeanDelta( double mean, double meansqr, double times, double beta )
+   {
+   double t = 0.0;
+   if ( fabs( beta - 0.95 ) < 0.0001 ) t = 1.960;
+   else if ( fabs( beta - 0.99 ) < 0.0001 ) t = 2.576;
+   else if ( fabs( beta - 0.999 ) < 0.0001 ) t = 3.291;
+
+   return t * sqrt( ( meansqr - mean * mean ) / ( times - 1.0 ) );
+   };
+
+
+double calcStudentMeanDelta( double mean, double meansqr, double times, double beta )
+   {
+   double x = 0.0;
+   if ( fabs( beta - 0.95 ) < 0.0001 ) x = 1.959964;
+   else if ( fabs( beta - 0.99 ) < 0.0001 ) x = 2.5758293;
+   else if ( fabs( beta - 0.999 ) < 0.0001 ) x = 3.2905267;
+
+   // Quantile of Student's distribution with n degrees of freedom is
+   // computed by Hill's algorithm ( CACM 396 ) from two-tailed p;
+   double n = times - 1.0;
+   double p = 1.0 - beta;
+   double t = 0.0;
+
+   if ( n < 1.5 )
+      {
+      t = cos( p * M_PI_2 ) / sin( p * M_PI_2 );
+      }
+   else if ( n < 2.5 )
+      {
+      t = sqrt( 2.0 / ( p * ( 2.0 - p ) ) - 2.0 );
+      }
+   else
+      {
+      double a = 1.0 / ( n - 0.5 );
+      double b = 48.0 / ( a * a );
+      double c = ( ( 20700.0 * a / b - 98.0 ) * a - 16.0 ) * a + 96.36;
+      double d = ( ( 94.5 / ( b + c ) - 3.0 ) / b + 1.0 ) * sqrt( a * M_PI_2 ) * n;
+      double y = pow( d * p, 2.0 / n );
+
+      if ( y > 0.05 + a )
+         {
+         // Asymptotic inverse expansion about normal;
+         y = x * x;
+         if ( n < 5.0 ) c += 0.3 * ( n - 4.5 ) * ( x + 0.6 );
+         c = ( ( ( 0.05 * d * x - 5.0 ) * x - 7.0 ) * x - 2.0 ) * x + b + c;
+         y = ( ( ( ( ( 0.4 * y + 6.3 ) * y + 36.0 ) * y + 94.5 ) / c - y - 3.0 ) / b + 1.0 ) * x;
+         y = a * y * y;
+         y = ( y > 0.002 ) ? exp( y ) - 1.0 : 0.5 * y * y + y;
+         }
+      else
+         {
+         y = ( ( 1.0 / ( ( ( n + 6.0 ) / ( n * y ) - 0.089 * d - 0.822 ) * ( n + 2.0 ) * 3.0 ) +
+            0.5 / ( n + 4.0 ) ) * y - 1.0 ) * ( n + 1.0 ) / ( n + 2.0 ) + 1.0 / y;
+         }
+
+      t = sqrt( n * y );
+      }
+
+   return t * sqrt( ( meansqr - mean * mean ) / ( times - 1.0 ) );
+   };
+
+
+double calcControlledMean(
+   const std::vector< double > & values,
+   const std::vector< double > & controls,
+   double controlMean,
+   double beta,
+   double & delta
+   )
+   {
+   unsigned int n = values.size();
+   double my = 0.0;
+   double mc = 0.0;
+   for ( unsigned int i = 0; i < n; i ++ )
+      {
+      my += values[ i ];
+      mc += controls[ i ];
+      }
+
+   my /= n;
+   mc /= n;
+
+   double sxx = 0.0;
+   double sxy = 0.0;
+   for ( unsigned int i = 0; i < n; i ++ )
+      {
+      sxx += ( controls[ i ] - mc ) * ( controls[ i ] - mc );
+      sxy += ( controls[ i ] - mc ) * ( values[ i ] - my );
+      }
+
+   double b = ( sxx > 0.0 ) ? sxy / sxx : 0.0;
+   double mean = my - b * ( mc - controlMean );
+
+   double ssr = 0.0;
+   for ( unsigned int i = 0; i < n; i ++ )
+      {
+      double r = values[ i ] - my - b * ( controls[ i ] - mc );
+      ssr += r * r;
+      }
+
+   // Regression line is evaluated at controlMean, and residuals have
+   // n - 2 degrees of freedom, which is the Student interval of n - 1
+   // values with the same variance;
+   double variance = ssr / ( n - 2.0 ) / n;
+   if ( sxx > 0.0 ) variance += ssr / ( n - 2.0 ) * ( mc - controlMean ) * ( mc - controlMean ) / sxx;
+
+   delta = calcStudentMeanDelta( 0.0, variance * ( n - 2.0 ), n - 1.0, beta );
+   return mean;
+   };
+
+
+double calcCountsMean(
+   const std::vector< double > & counts,
+   const std::vector< double > & values,
+   double beta,
+   double & delta
+   )
+   {
+   double times = 0.0;
+   double mean = 0.0;
+   double meansqr = 0.0;
+   for ( unsigned int k = 0; k < counts.size() && k < values.size(); k ++ )
+      {
+      times += counts[ k ];
+      mean += counts[ k ] * values[ k ];
+      meansqr += counts[ k ] * values[ k ] * values[ k ];
+      }
+
+   delta = 0.0;
+   if ( times <= 0.0 ) return 0.0;
+
+   mean /= times;
+   meansqr /= times;
+   if ( meansqr < mean * mean ) meansqr = mean * mean;
+   if ( times > 1.0 ) delta = calcMeanDelta( mean, meansqr, times, beta );
+   return mean;
+   };
+
+
+void calcACProbabilityBounds(
+   double p,
+   double times,
+   double alpha,
+   double & lower,
+   double & upper
+   )
+   {
+   double x = 0.0;
+   if ( fabs( alpha - 0.05 ) < 0.0001 ) x = 1.959964;
+   else if ( fabs( alpha - 0.01 ) < 0.0001 ) x = 2.5758293;
+   else if ( fabs( alpha - 0.001 ) < 0.0001 ) x = 3.2905267;
+
+   double timesAC = times + x * x;
+   double pAC = ( p * times + 0.5 * x * x ) / timesAC;
+   double delta = x * sqrt( pAC * ( 1.0 - pAC ) / timesAC );
+
+   lower = pAC - delta;
+   upper = pAC + delta;
+   };
+
+
+/***************************************************************************
+ *   Survival polynomial functions implementation                          *
+ ***************************************************************************/
+
+
+void calcBinomialDistribution( unsigned int n, double p, std::vector< double > & pmf )
+   {
+   pmf.assign( n + 1, 0.0 );
+
+   // Degenerate p fails none or all of components;
+   if ( p <= 0.0 || p >= 1.0 )
+      {
+      pmf[ ( p <= 0.0 ) ? 0 : n ] = 1.0;
+      return;
+      }
+
+   double logP = log( p );
+   double logQ = log1p( - p );
+   double logN = lgamma( n + 1.0 );
+   for ( unsigned int k = 0; k <= n; k ++ )
+      {
+      pmf[ k ] = exp( logN - lgamma( k + 1.0 ) - lgamma( n - k + 1.0 ) + k * logP + ( n - k ) * logQ );
+      }
+   };
+
+
+void calcSurvivalPolynomial(
+   const std::vector< double > & counts,
+   unsigned int n,
+   double p,
+   double & lower,
+   double & upper
+   )
+   {
+   lower = 0.0;
+   upper = 0.0;
+
+   unsigned int limit = ( counts.size() < n + 1 ) ? counts.size() : n + 1;
+
+   // Degenerate p fails none or all of components;
+   if ( p <= 0.0 || p >= 1.0 )
+      {
+      unsigned int k = ( p <= 0.0 ) ? 0 : n;
+      lower = ( k < limit ) ? counts[ k ] : 0.0;
+      upper = ( k < limit ) ? counts[ k ] : 1.0;
+      return;
+      }
+
+   // Probabilities are taken in logarithms, which do not overflow for
+   // large numbers of sets;
+   double logP = log( p );
+   double logQ = log1p( - p );
+   double logN = lgamma( n + 1.0 );
+   for ( unsigned int k = 0; k <= n; k ++ )
+      {
+      double logProbability = k * logP + ( n - k ) * logQ;
+      if ( k < limit )
+         {
+         lower += counts[ k ] * exp( logProbability );
+         }
+      else
+         {
+         upper += exp( logN - lgamma( k + 1.0 ) - lgamma( n - k + 1.0 ) + logProbability );
+         }
+      }
+
+   upper += lower;
+   };
+
+
+void calcCutSetsBounds(
+   const std::vector< std::vector< unsigned int > > & cutSets,
+   const std::vector< double > & p,
+   unsigned int maxFaults,
+   double & lower,
+   double & upper
+   )
+   {
+   std::vector< double > cutProbabilities( cutSets.size(), 1.0 );
+   for ( unsigned int j = 0; j < cutSets.size(); j ++ )
+      {
+      for ( unsigned int i = 0; i < cutSets[ j ].size(); i ++ ) cutProbabilities[ j ] *= p[ cutSets[ j ][ i ] ];
+      }
+
+   // Union of two cut sets fails with product over their union, sets
+   // are sorted, so the union is merged in linear time;
+   double s1 = 0.0;
+   double s2 = 0.0;
+   double survival = 1.0;
+   for ( unsigned int j = 0; j < cutSets.size(); j ++ )
+      {
+      s1 += cutProbabilities[ j ];
+      survival *= 1.0 - cutProbabilities[ j ];
+
+      for ( unsigned int l = j + 1; l < cutSets.size(); l ++ )
+         {
+         double x = cutProbabilities[ l ];
+         unsigned int a = 0;
+         unsigned int b = 0;
+         while ( a < cutSets[ j ].size() )
+            {
+            while ( b < cutSets[ l ].size() && cutSets[ l ][ b ] < cutSets[ j ][ a ] ) b ++;
+            if ( b == cutSets[ l ].size() || cutSets[ l ][ b ] != cutSets[ j ][ a ] ) x *= p[ cutSets[ j ][ a ] ];
+            a ++;
+            }
+
+         s2 += x;
+         }
+      }
+
+   // Disjoint cut sets fail independently, they are picked greedily from
+   // the most probable one;
+   std::vector< std::pair< double, unsigned int > > order;
+   for ( unsigned int j = 0; j < cutSets.size(); j ++ )
+      {
+      order.push_back( std::make_pair( - cutProbabilities[ j ], j ) );
+      }
+
+   std::sort( order.begin(), order.end() );
+
+   double disjointSurvival = 1.0;
+   std::vector< bool > used( p.size(), false );
+   for ( unsigned int j = 0; j < order.size(); j ++ )
+      {
+      const std::vector< unsigned int > & cutSet = cutSets[ order[ j ].second ];
+
+      bool disjoint = true;
+      for ( unsigned int i = 0; i < cutSet.size() && disjoint; i ++ ) disjoint = ! used[ cutSet[ i ] ];
+      if ( ! disjoint ) continue;
+
+      for ( unsigned int i = 0; i < cutSet.size(); i ++ ) used[ cutSet[ i ] ] = true;
+      disjointSurvival *= 1.0 - cutProbabilities[ order[ j ].second ];
+      }
+
+   lower = ( s1 - s2 > 1.0 - disjointSurvival ) ? s1 - s2 : 1.0 - disjointSurvival;
+   upper = 1.0 - survival;
+
+   // Failed sets without known cut set have more than maxFaults failed
+   // components, whose count is accumulated in the last cell;
+   if ( maxFaults < p.size() )
+      {
+      std::vector< double > counts( maxFaults + 2, 0.0 );
+      counts[ 0 ] = 1.0;
+      for ( unsigned int i = 0; i < p.size(); i ++ )
+         {
+         counts[ maxFaults + 1 ] += counts[ maxFaults ] * p[ i ];
+         for ( unsigned int k = maxFaults; k > 0; k -- )
+            {
+            counts[ k ] = counts[ k ] * ( 1.0 - p[ i ] ) + counts[ k - 1 ] * p[ i ];
+            }
+
+         counts[ 0 ] *= 1.0 - p[ i ];
+         }
+
+      upper += counts[ maxFaults + 1 ];
+      }
+
+   if ( lower > 1.0 ) lower = 1.0;
+   if ( upper > 1.0 ) upper = 1.0;
+   };
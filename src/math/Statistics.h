@@ -0,0 +1,112 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+
+#include <vector>
+
+
+/***************************************************************************
+ *   Confidence intervals functions declaration                            *
+ ***************************************************************************/
+
+
+// Returns half-width of normal confidence interval for the mean estimated
+// by times replicas with given mean and mean of squares, beta is one of
+// 0.95, 0.99 or 0.999;
+double calcMeanDelta( double mean, double meansqr, double times, double beta );
+
+// The same for a few independent estimates, e.g. randomizations of QMC
+// point set, where normal quantile is replaced by Student's one;
+double calcStudentMeanDelta( double mean, double meansqr, double times, double beta );
+
+// Control variate estimate of the mean of independent values, which is
+// adjusted by their regression on controls with known mean controlMean.
+// Delta is half-width of Student interval of the adjusted mean, beta is
+// one of 0.95, 0.99 or 0.999. At least three values are needed;
+double calcControlledMean(
+   const std::vector< double > & values,
+   const std::vector< double > & controls,
+   double controlMean,
+   double beta,
+   double & delta
+   );
+
+// Mean of values[ K ] over replicas, counts[ k ] of which have K = k,
+// delta is half-width of normal interval;
+double calcCountsMean(
+   const std::vector< double > & counts,
+   const std::vector< double > & values,
+   double beta,
+   double & delta
+   );
+
+// Computes Agresti-Coull interval for probability p estimated by times
+// replicas, alpha is one of 0.05, 0.01 or 0.001;
+void calcACProbabilityBounds(
+   double p,
+   double times,
+   double alpha,
+   double & lower,
+   double & upper
+   );
+
+
+/***************************************************************************
+ *   Survival polynomial functions declaration                             *
+ ***************************************************************************/
+
+
+// Fills pmf[ k ] = P( Bin( n, p ) = k ), k = 0, ..., n;
+void calcBinomialDistribution( unsigned int n, double p, std::vector< double > & pmf );
+
+
+// Computes survival probability of n independent components, each failed
+// with probability p, from counts[ k ] of sets of k failed components that
+// survive. Larger sets are taken as failed for lower bound and as
+// surviving for upper one, so the bounds are equal if all the sets are
+// counted;
+void calcSurvivalPolynomial(
+   const std::vector< double > & counts,
+   unsigned int n,
+   double p,
+   double & lower,
+   double & upper
+   );
+
+
+// Bounds unreliability of coherent system of independent components, where
+// component i fails with probability p[ i ], by its minimal cut sets. Lower
+// bound is the larger of the second Bonferroni inequality and failure of
+// any of disjoint cut sets, upper one is Esary-Proschan bound. If cut sets are
+// known only up to maxFaults components, upper bound adds probability of
+// more than maxFaults failed components;
+void calcCutSetsBounds(
+   const std::vector< std::vector< unsigned int > > & cutSets,
+   const std::vector< double > & p,
+   unsigned int maxFaults,
+   double & lower,
+   double & upper
+   );
+
+
+#endif
@@ -0,0 +1,98 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#ifndef VECTORMATH_H
+#define VECTORMATH_H
+
+
+#include <stdint.h>
+#include <string.h>
+
+
+// Logarithm and exponent kernels without branches and table lookups, so
+// loops over arrays are vectorized by compiler. Both are accurate to
+// about 1 ulp for positive normal arguments of log and arguments of exp
+// from [-708, 709], which covers failure times sampling;
+
+
+inline uint64_t doubleToBits( double x )
+   {
+   uint64_t bits;
+   memcpy( & bits, & x, sizeof( bits ) );
+   return bits;
+   };
+
+
+inline double bitsToDouble( uint64_t bits )
+   {
+   double x;
+   memcpy( & x, & bits, sizeof( x ) );
+   return x;
+   };
+
+
+inline double vectorLog( double x )
+   {
+   // Split x into 2^k * m, where m is from [sqrt( 0.5 ), sqrt( 2 ) );
+   const uint64_t sqrtHalf = 0x3FE6A09E667F3BCDULL;
+   uint64_t bits = doubleToBits( x ) - sqrtHalf;
+   uint64_t biasedK = ( bits + 0x3FF0000000000000ULL ) >> 52;
+   double m = bitsToDouble( ( bits & 0x000FFFFFFFFFFFFFULL ) + sqrtHalf );
+
+   // Convert k to double through mantissa of 2^52;
+   double k = bitsToDouble( biasedK | 0x4330000000000000ULL ) - ( 4503599627370496.0 + 1023.0 );
+
+   // log( m ) = log( 1 + f ) = 2 * atanh( s ), where s = f / ( 2 + f );
+   double f = m - 1.0;
+   double s = f / ( 2.0 + f );
+   double z = s * s;
+   double w = z * z;
+   double t1 = w * ( 3.999999999940941908e-01 + w * ( 2.222219843214978396e-01 + w * 1.531383769920937332e-01 ) );
+   double t2 = z * ( 6.666666666666735130e-01 + w * ( 2.857142874366239149e-01 + w * ( 1.818357216161805012e-01 + w * 1.479819860511658591e-01 ) ) );
+   double r = t1 + t2;
+   double hfsq = 0.5 * f * f;
+
+   return k * 6.93147180369123816490e-01 - ( ( hfsq - ( s * ( hfsq + r ) + k * 1.90821492927058770002e-10 ) ) - f );
+   };
+
+
+inline double vectorExp( double x )
+   {
+   // Keep result and scale normal;
+   x = ( x < -708.0 ) ? -708.0 : x;
+   x = ( x > 709.0 ) ? 709.0 : x;
+
+   // Round x / ln( 2 ) to the nearest integer k through mantissa of 1.5 * 2^52;
+   const double shift = 6755399441055744.0;
+   double kShifted = x * 1.44269504088896338700e+00 + shift;
+   double k = kShifted - shift;
+   uint64_t scaleBits = ( doubleToBits( kShifted ) - doubleToBits( shift ) + 1023 ) << 52;
+
+   // exp( x ) = 2^k * exp( r ), where |r| <= ln( 2 ) / 2;
+   double r = ( x - k * 6.93147180369123816490e-01 ) - k * 1.90821492927058770002e-10;
+   double z = r * r;
+   double c = r - z * ( 1.66666666666666019037e-01 + z * ( -2.77777777770155933842e-03 + z * ( 6.61375632143793436117e-05 + z * ( -1.65339022054652515390e-06 + z * 4.13813679705723846039e-08 ) ) ) );
+   double y = 1.0 - ( ( r * c ) / ( c - 2.0 ) - r );
+
+   return y * bitsToDouble( scaleBits );
+   };
+
+
+#endif
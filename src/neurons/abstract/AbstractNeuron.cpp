@@ -130,6 +130,42 @@ unsigned int AbstractNeuron::getInputsCount() const
    };
 
 
+unsigned int AbstractNeuron::getInputConnector( unsigned int index ) const
+   {
+   return this->inputConnectors[ index ];
+   };
+
+
+AbstractConnectors * AbstractNeuron::getConnectors()
+   {
+   return this->connectors;
+   };
+
+
+unsigned int AbstractNeuron::getOutputConnector() const
+   {
+   return this->connectorsBaseIndex;
+   };
+
+
+AbstractWeights * AbstractNeuron::getWeights()
+   {
+   return this->weights;
+   };
+
+
+unsigned int AbstractNeuron::getWeightsBaseIndex() const
+   {
+   return this->weightsBaseIndex;
+   };
+
+
+unsigned int AbstractNeuron::getWeightsCount() const
+   {
+   return this->inputsCount;
+   };
+
+
 void AbstractNeuron::setWeight( unsigned int index, double weight )
    {
    if ( this->weights == NULL )
@@ -141,6 +177,7 @@ void AbstractNeuron::setWeight( unsigned int index, double weight )
       {
       // Set external weight;
       this->weights->at( weightsBaseIndex + index ) = weight;
+      this->weights->touch();
       }
    };
 
@@ -264,6 +301,8 @@ void AbstractNeuron::modifyWeights( double damping, double speed )
          builtInBuffers[ i ] = dw;
          weights->at( weightsBaseIndex + i ) += dw;
          }
+
+      weights->touch();
       }
    };
 
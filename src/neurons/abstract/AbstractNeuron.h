@@ -72,6 +72,16 @@ class AbstractNeuron : public KernelObject
       virtual ~AbstractNeuron();
 
       unsigned int getInputsCount() const;
+      unsigned int getInputConnector( unsigned int index ) const;
+
+      AbstractConnectors * getConnectors();
+      unsigned int getOutputConnector() const;
+
+      // NULL for neurons with built-in weights;
+      AbstractWeights * getWeights();
+      unsigned int getWeightsBaseIndex() const;
+      // Every processing unit reads one weight per input;
+      unsigned int getWeightsCount() const;
 
       void setWeight( unsigned int index, double weight );
       double getWeight( unsigned int index );
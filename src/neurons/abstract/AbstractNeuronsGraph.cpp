@@ -0,0 +1,251 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#include "neurons/abstract/AbstractNeuronsGraph.h"
+
+
+#include <map>
+
+
+/***************************************************************************
+ *   AbstractNeuronsGraph class implementation                             *
+ ***************************************************************************/
+
+
+AbstractNeuronsGraph::AbstractNeuronsGraph( const std::vector< AbstractNeuron * > & neurons )
+   : KernelObject()
+   {
+   this->neurons = neurons;
+   this->connectors = ( neurons.size() > 0 ) ? neurons[ 0 ]->getConnectors() : NULL;
+   this->incremental = ( this->connectors != NULL );
+   this->consumers.resize( neurons.size() );
+   this->dirty.assign( neurons.size(), false );
+
+   // Capture objects;
+   for ( unsigned int i = 0; i < neurons.size(); i ++ ) neurons[ i ]->capture();
+
+   // Find out neuron writing each connector;
+   std::map< unsigned int, unsigned int > writers;
+   for ( unsigned int i = 0; i < neurons.size() && this->incremental; i ++ )
+      {
+      if ( neurons[ i ]->getConnectors() != this->connectors ||
+         neurons[ i ]->getWeights() == NULL ||
+         ! writers.insert( std::make_pair( neurons[ i ]->getOutputConnector(), i ) ).second
+         ) this->incremental = false;
+      }
+
+   // Neurons are computed in given order, so they may read only outputs
+   // of preceding ones;
+   std::map< unsigned int, bool > inputs;
+   for ( unsigned int i = 0; i < neurons.size() && this->incremental; i ++ )
+      {
+      for ( unsigned int j = 0; j < neurons[ i ]->getInputsCount(); j ++ )
+         {
+         unsigned int connector = neurons[ i ]->getInputConnector( j );
+         std::map< unsigned int, unsigned int >::iterator writer = writers.find( connector );
+
+         if ( writer == writers.end() )
+            {
+            if ( inputs.insert( std::make_pair( connector, true ) ).second )
+               {
+               this->inputConnectors.push_back( connector );
+               }
+            }
+         else if ( writer->second < i )
+            {
+            this->consumers[ writer->second ].push_back( i );
+            }
+         else
+            {
+            this->incremental = false;
+            }
+         }
+      }
+
+   // Map weights read by processing units to their neurons, shared
+   // weights or weights out of range can not be mapped;
+   for ( unsigned int i = 0; i < neurons.size() && this->incremental; i ++ )
+      {
+      AbstractWeights * neuronWeights = neurons[ i ]->getWeights();
+
+      unsigned int k = 0;
+      while ( k < this->weights.size() && this->weights[ k ] != neuronWeights ) k ++;
+
+      if ( k == this->weights.size() )
+         {
+         this->weights.push_back( neuronWeights );
+         this->owners.push_back( std::vector< int >( neuronWeights->count(), -1 ) );
+         }
+
+      unsigned int baseIndex = neurons[ i ]->getWeightsBaseIndex();
+      unsigned int weightsCount = neurons[ i ]->getWeightsCount();
+      for ( unsigned int j = 0; j < weightsCount && this->incremental; j ++ )
+         {
+         if ( baseIndex + j >= this->owners[ k ].size() ||
+            this->owners[ k ][ baseIndex + j ] >= 0
+            )
+            {
+            this->incremental = false;
+            }
+         else
+            {
+            this->owners[ k ][ baseIndex + j ] = i;
+            }
+         }
+      }
+   };
+
+
+AbstractNeuronsGraph::~AbstractNeuronsGraph()
+   {
+   // Release captured objects;
+   for ( unsigned int i = 0; i < this->neurons.size(); i ++ ) this->neurons[ i ]->release();
+   };
+
+
+bool AbstractNeuronsGraph::isIncremental() const
+   {
+   return this->incremental;
+   };
+
+
+void AbstractNeuronsGraph::compute( unsigned int key )
+   {
+   if ( ! this->incremental )
+      {
+      this->computeAll();
+      return;
+      }
+
+   if ( key >= this->golden.size() )
+      {
+      Golden empty;
+      empty.valid = false;
+      empty.epoch = 0;
+      this->golden.resize( key + 1, empty );
+      }
+
+   Golden & vector = this->golden[ key ];
+   unsigned int epoch = this->getEpoch();
+
+   bool faulted = false;
+   for ( unsigned int k = 0; k < this->weights.size(); k ++ )
+      {
+      if ( ! this->weights[ k ]->getFaulted().empty() ) faulted = true;
+      }
+
+   // Golden activations are taken for the same inputs and weights only;
+   bool valid = vector.valid && vector.epoch == epoch;
+   for ( unsigned int i = 0; i < this->inputConnectors.size() && valid; i ++ )
+      {
+      if ( this->connectors->at( this->inputConnectors[ i ] ) != vector.inputs[ i ] ) valid = false;
+      }
+
+   if ( ! valid )
+      {
+      this->computeAll();
+      if ( faulted ) return;
+
+      // Remember fault-free activations;
+      vector.valid = true;
+      vector.epoch = epoch;
+      vector.inputs.resize( this->inputConnectors.size() );
+      for ( unsigned int i = 0; i < this->inputConnectors.size(); i ++ )
+         {
+         vector.inputs[ i ] = this->connectors->at( this->inputConnectors[ i ] );
+         }
+
+      vector.outputs.resize( this->neurons.size() );
+      for ( unsigned int i = 0; i < this->neurons.size(); i ++ )
+         {
+         vector.outputs[ i ] = this->neurons[ i ]->getOutput();
+         }
+
+      return;
+      }
+
+   // Restore golden activations;
+   for ( unsigned int i = 0; i < this->neurons.size(); i ++ )
+      {
+      this->connectors->at( this->neurons[ i ]->getOutputConnector() ) = vector.outputs[ i ];
+      }
+
+   if ( ! faulted ) return;
+
+   // Mark neurons owning faulted weights;
+   unsigned int first = this->neurons.size();
+   for ( unsigned int k = 0; k < this->weights.size(); k ++ )
+      {
+      const std::vector< unsigned int > & faults = this->weights[ k ]->getFaulted();
+      for ( unsigned int i = 0; i < faults.size(); i ++ )
+         {
+         int owner = ( faults[ i ] < this->owners[ k ].size() ) ? this->owners[ k ][ faults[ i ] ] : -1;
+         if ( owner < 0 ) continue;
+
+         this->dirty[ owner ] = true;
+         if ( ( unsigned int ) owner < first ) first = owner;
+         }
+      }
+
+   // Recompute cone of faulted neurons, which ends at unchanged outputs;
+   for ( unsigned int i = first; i < this->neurons.size(); i ++ )
+      {
+      if ( ! this->dirty[ i ] ) continue;
+
+      this->dirty[ i ] = false;
+      this->neurons[ i ]->compute();
+
+      if ( this->neurons[ i ]->getOutput() != vector.outputs[ i ] )
+         {
+         for ( unsigned int j = 0; j < this->consumers[ i ].size(); j ++ )
+            {
+            this->dirty[ this->consumers[ i ][ j ] ] = true;
+            }
+         }
+      }
+   };
+
+
+AbstractNeuronsGraph::AbstractNeuronsGraph()
+   : KernelObject()
+   {
+   // Do nothing;
+   };
+
+
+AbstractNeuronsGraph::AbstractNeuronsGraph( const AbstractNeuronsGraph & other )
+   {
+   // Do nothing;
+   };
+
+
+void AbstractNeuronsGraph::computeAll()
+   {
+   for ( unsigned int i = 0; i < this->neurons.size(); i ++ ) this->neurons[ i ]->compute();
+   };
+
+
+unsigned int AbstractNeuronsGraph::getEpoch() const
+   {
+   unsigned int epoch = 0;
+   for ( unsigned int k = 0; k < this->weights.size(); k ++ ) epoch += this->weights[ k ]->getEpoch();
+
+   return epoch;
+   };
@@ -0,0 +1,94 @@
+/***************************************************************************
+ *   Copyright (C) 2009, 2010 Andrew Timashov                              *
+ *                                                                         *
+ *   This file is part of NeuroWombat.                                     *
+ *                                                                         *
+ *   NeuroWombat is free software: you can redistribute it and/or modify   *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   NeuroWombat is distributed in the hope that it will be useful,        *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with NeuroWombat.  If not, see <http://www.gnu.org/licenses/>.  *
+ ***************************************************************************/
+
+
+#ifndef ABSTRACTNEURONSGRAPH_H
+#define ABSTRACTNEURONSGRAPH_H
+
+
+#include <vector>
+
+
+#include "kernel/KernelObject.h"
+#include "components/abstract/AbstractConnectors.h"
+#include "components/abstract/AbstractWeights.h"
+#include "neurons/abstract/AbstractNeuron.h"
+
+
+/***************************************************************************
+ *   AbstractNeuronsGraph class declaration                                *
+ ***************************************************************************/
+
+
+// Feed-forward neurons are computed once per test vector with fault-free
+// weights, and later only the neurons depending on faulted weights are
+// recomputed from these golden activations. Neurons have to share
+// connectors and external weights, read only outputs of preceding
+// neurons and own disjoint ranges of weights, otherwise they are
+// computed in full on every call;
+class AbstractNeuronsGraph : public KernelObject
+   {
+   public:
+      AbstractNeuronsGraph( const std::vector< AbstractNeuron * > & neurons );
+      virtual ~AbstractNeuronsGraph();
+
+      bool isIncremental() const;
+
+      // Computes neurons once for input signals of test vector key,
+      // giving the same outputs as computing all of them;
+      void compute( unsigned int key );
+
+   protected:
+      AbstractNeuronsGraph();
+      AbstractNeuronsGraph( const AbstractNeuronsGraph & other );
+
+   private:
+      struct Golden
+         {
+         bool valid;
+         unsigned int epoch;
+         std::vector< double > inputs;
+         std::vector< double > outputs;
+         };
+
+      void computeAll();
+
+      // Sum of weights epochs, which is changed by any of them;
+      unsigned int getEpoch() const;
+
+      std::vector< AbstractNeuron * > neurons;
+      AbstractConnectors * connectors;
+      bool incremental;
+
+      // Connectors read by neurons but written by none of them;
+      std::vector< unsigned int > inputConnectors;
+
+      // Indices of neurons reading output of each neuron;
+      std::vector< std::vector< unsigned int > > consumers;
+
+      // Index of neuron owning each weight of each weights set;
+      std::vector< AbstractWeights * > weights;
+      std::vector< std::vector< int > > owners;
+
+      std::vector< Golden > golden;
+      std::vector< bool > dirty;
+   };
+
+
+#endif
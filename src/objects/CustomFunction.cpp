@@ -29,6 +29,18 @@
 extern Kernel * kernel;
 
 
+/***************************************************************************
+ *   CustomFunctionExcp class implementation                               *
+ ***************************************************************************/
+
+
+CustomFunctionExcp::CustomFunctionExcp( NS_CUSTOMFUNCTION::EC error )
+   : Exception < NS_CUSTOMFUNCTION::EC > ( error )
+   {
+   // Do nothing;
+   };
+
+
 /***************************************************************************
  *   CustomFunction abstract class implementation                          *
  ***************************************************************************/
@@ -69,6 +81,35 @@ double CustomFunction::call( double x ) const
    };
 
 
+double CustomFunction::callScore( double x ) const
+   {
+   lua_State * L = kernel->getVM();
+   lua_rawgeti( L, LUA_REGISTRYINDEX, functionReference );
+   lua_pushnumber( L, x );
+
+   // Keep error message for API function;
+   if ( lua_pcall( L, 1, 1, 0 ) != 0 ) throw CustomFunctionExcp( NS_CUSTOMFUNCTION::CALL_FAILED );
+
+   double result = lua_tonumber( L, -1 );
+   lua_pop( L, 1 );
+   return result;
+   };
+
+
+bool CustomFunction::callPredicate() const
+   {
+   lua_State * L = kernel->getVM();
+   lua_rawgeti( L, LUA_REGISTRYINDEX, functionReference );
+
+   // Keep error message for API function;
+   if ( lua_pcall( L, 0, 1, 0 ) != 0 ) throw CustomFunctionExcp( NS_CUSTOMFUNCTION::CALL_FAILED );
+
+   bool result = lua_toboolean( L, -1 );
+   lua_pop( L, 1 );
+   return result;
+   };
+
+
 int CustomFunction::getFunctionReference() const
    {
    return functionReference;
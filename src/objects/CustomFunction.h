@@ -22,9 +22,32 @@
 #define CUSTOMFUNCTION_H
 
 
+#include "exceptions.h"
 #include "kernel/KernelObject.h"
 
 
+/***************************************************************************
+ *   CustomFunctionExcp class declaration                                  *
+ ***************************************************************************/
+
+
+namespace NS_CUSTOMFUNCTION
+   {
+   enum EC
+      {
+      CALL_FAILED
+      };
+   };
+
+
+// Error message of failed call is left on the top of Lua stack;
+class CustomFunctionExcp : public Exception < NS_CUSTOMFUNCTION::EC >
+   {
+   public:
+      CustomFunctionExcp( NS_CUSTOMFUNCTION::EC error );
+   };
+
+
 /***************************************************************************
  *   CustomFunction abstract class declaration                             *
  ***************************************************************************/
@@ -39,6 +62,11 @@ class CustomFunction : public KernelObject
       void call() const;
       double call( double x ) const;
 
+      // The same as call(), but errors in function throw
+      // CustomFunctionExcp, so estimates are not biased by them;
+      double callScore( double x ) const;
+      bool callPredicate() const;
+
       int getFunctionReference() const;
 
    private: